@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "zmq.hpp"
+
+// Shared helpers for the localhost IPC benchmarks. Each benchmark runs one of
+// the real communication classes against a stand-in peer that speaks the same
+// wire protocol on the same ports, so both executables must not run at once.
+
+namespace ipc_bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed_us(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+struct Options {
+  int pings = 1000;       // round trips for the latency test
+  int edits = 20000;      // property edit messages for the throughput test
+  int syncs = 200;        // scene snapshots for the sync test
+  int entities = 500;     // entities per synthetic scene
+  int variants = 4;       // variants per synthetic entity
+  int frame_ms = 0;       // consumer drains once per frame, 0 = busy drain
+  int timeout_ms = 10000;  // per test, a stuck test is reported and skipped
+};
+
+inline Options parse_options(int argc, char* argv[]) {
+  Options options;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string key = argv[i];
+    int value = std::atoi(argv[i + 1]);
+
+    if (key == "--pings") {
+      options.pings = value;
+    } else if (key == "--edits") {
+      options.edits = value;
+    } else if (key == "--syncs") {
+      options.syncs = value;
+    } else if (key == "--entities") {
+      options.entities = value;
+    } else if (key == "--variants") {
+      options.variants = value;
+    } else if (key == "--frame-ms") {
+      options.frame_ms = value;
+    } else if (key == "--timeout-ms") {
+      options.timeout_ms = value;
+    } else {
+      std::fprintf(stderr, "Unknown option: %s\n", key.c_str());
+    }
+  }
+
+  return options;
+}
+
+// latency samples in microseconds
+class Stats {
+public:
+  void add(double sample_us) { m_samples.push_back(sample_us); }
+  size_t count() const { return m_samples.size(); }
+
+  void print(const char* name) {
+    if (m_samples.empty()) {
+      std::printf("%-28s no samples\n", name);
+      return;
+    }
+
+    std::sort(m_samples.begin(), m_samples.end());
+
+    double sum = 0.0;
+    for (double sample : m_samples) sum += sample;
+
+    std::printf(
+        "%-28s n=%-6zu mean=%9.1fus p50=%9.1fus p99=%9.1fus max=%9.1fus\n",
+        name, m_samples.size(), sum / m_samples.size(), percentile(0.50),
+        percentile(0.99), m_samples.back());
+  }
+
+private:
+  double percentile(double p) const {
+    size_t index = static_cast<size_t>(p * (m_samples.size() - 1));
+    return m_samples[index];
+  }
+
+  std::vector<double> m_samples;
+};
+
+inline void print_throughput(const char* name, size_t messages, size_t bytes,
+                             double duration_us) {
+  double seconds = duration_us / 1e6;
+  std::printf("%-28s n=%-6zu %10.0f msg/s %9.2f MB/s (%.1fms)\n", name,
+              messages, messages / seconds, bytes / seconds / (1024.0 * 1024.0),
+              duration_us / 1000.0);
+}
+
+// paces the consumer side like a UI or game frame loop would
+inline void wait_frame(const Options& options) {
+  if (options.frame_ms > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(options.frame_ms));
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+inline std::string to_string(const rapidjson::Document& doc) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+// same layout Zeytin::serialize_scene produces, "type" must stay first
+inline std::string make_scene(const Options& options, uint64_t sync_seq) {
+  rapidjson::Document doc;
+  doc.SetObject();
+  auto& allocator = doc.GetAllocator();
+
+  doc.AddMember("type", "scene", allocator);
+  if (sync_seq != 0) {
+    doc.AddMember("sync_seq", sync_seq, allocator);
+  }
+
+  rapidjson::Value entities(rapidjson::kArrayType);
+  for (int e = 0; e < options.entities; e++) {
+    rapidjson::Value entity(rapidjson::kObjectType);
+    entity.AddMember("entity_id", static_cast<uint64_t>(e + 1), allocator);
+
+    rapidjson::Value variants(rapidjson::kArrayType);
+    for (int v = 0; v < options.variants; v++) {
+      rapidjson::Value value(rapidjson::kObjectType);
+      value.AddMember("x", e * 1.5f, allocator);
+      value.AddMember("y", v * 2.5f, allocator);
+
+      rapidjson::Value variant(rapidjson::kObjectType);
+      variant.AddMember("type", "Position", allocator);
+      variant.AddMember("value", value, allocator);
+      variants.PushBack(variant, allocator);
+    }
+
+    entity.AddMember("variants", variants, allocator);
+    entities.PushBack(entity, allocator);
+  }
+
+  doc.AddMember("entities", entities, allocator);
+  return to_string(doc);
+}
+
+inline uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+// bench_sent_us is ignored by the real handlers, both peers live in one
+// process so it measures send-to-dispatch time including queueing
+inline std::string make_property_edit(uint64_t entity_id, int value,
+                                      const char* key_path = "x") {
+  rapidjson::Document doc;
+  doc.SetObject();
+  auto& allocator = doc.GetAllocator();
+
+  std::string value_str = std::to_string(value);
+
+  doc.AddMember("type", "entity_property_changed", allocator);
+  doc.AddMember("entity_id", entity_id, allocator);
+  doc.AddMember("variant_type", "Position", allocator);
+  doc.AddMember("key_type", "float", allocator);
+  doc.AddMember("key_path", rapidjson::StringRef(key_path), allocator);
+  doc.AddMember("value", rapidjson::Value(value_str.c_str(), allocator),
+                allocator);
+  doc.AddMember("bench_sent_us", now_us(), allocator);
+  return to_string(doc);
+}
+
+inline std::string make_simple_message(const char* type, const char* key = "",
+                                       uint64_t value = 0) {
+  rapidjson::Document doc;
+  doc.SetObject();
+  auto& allocator = doc.GetAllocator();
+
+  doc.AddMember("type", rapidjson::StringRef(type), allocator);
+  if (key[0] != '\0') {
+    doc.AddMember(rapidjson::StringRef(key), value, allocator);
+  }
+  return to_string(doc);
+}
+
+// cheap type check for the peer side, parses only as much as needed
+inline std::string message_type(const std::string& msg) {
+  rapidjson::Document doc;
+  doc.Parse(msg.c_str());
+  if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("type") ||
+      !doc["type"].IsString()) {
+    return "";
+  }
+  return doc["type"].GetString();
+}
+
+inline uint64_t message_uint(const std::string& msg, const char* key) {
+  rapidjson::Document doc;
+  doc.Parse(msg.c_str());
+  if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember(key) ||
+      !doc[key].IsUint64()) {
+    return 0;
+  }
+  return doc[key].GetUint64();
+}
+
+template <typename Socket>
+bool recv_string(Socket& socket, std::string& out, int timeout_ms) {
+  zmq::pollitem_t items[] = {{static_cast<void*>(socket), 0, ZMQ_POLLIN, 0}};
+  zmq::poll(items, 1, std::chrono::milliseconds(timeout_ms));
+
+  if (!(items[0].revents & ZMQ_POLLIN)) {
+    return false;
+  }
+
+  zmq::message_t message;
+  if (!socket.recv(message, zmq::recv_flags::none)) {
+    return false;
+  }
+
+  out.assign(static_cast<char*>(message.data()), message.size());
+  return true;
+}
+
+// waits for a message of the given type, everything else is skipped
+template <typename Socket>
+bool recv_type(Socket& socket, const char* type, std::string& out,
+               int timeout_ms) {
+  Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(timeout_ms);
+
+  while (Clock::now() < deadline) {
+    int remaining = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                              Clock::now())
+            .count());
+    if (!recv_string(socket, out, std::max(remaining, 1))) {
+      continue;
+    }
+    if (message_type(out) == type) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+template <typename Socket>
+void send_string(Socket& socket, const std::string& str) {
+  socket.send(zmq::message_t(str.data(), str.size()), zmq::send_flags::none);
+}
+
+}  // namespace ipc_bench
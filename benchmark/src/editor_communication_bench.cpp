@@ -0,0 +1,240 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "editor/editor_communication.h"
+#include "editor/editor_event.h"
+#include "ipc_bench.h"
+#include "remote_logger/remote_logger.h"
+
+// Benchmarks the engine side EditorCommunication. The main thread plays the
+// engine frame loop and drives the real class, a stand-in editor binds the
+// editor ports on a second thread and speaks the editor half of the protocol.
+
+using namespace ipc_bench;
+
+namespace {
+
+enum class Phase { Connecting, Messages, SyncBurst, SyncAcked, Done };
+
+struct Shared {
+  std::atomic<Phase> phase{Phase::Connecting};
+  std::atomic<bool> connected{false};
+  std::atomic<size_t> edits_received{0};
+
+  // written by the editor thread, read after join
+  Stats ping;
+  size_t edit_bytes = 0;
+  double edit_duration_us = 0.0;
+  size_t burst_received = 0;
+  size_t burst_bytes = 0;
+  double burst_duration_us = 0.0;
+};
+
+void run_pings(const Options& options, zmq::socket_t& publisher,
+               zmq::socket_t& subscriber, Shared& shared) {
+  std::string msg;
+
+  for (int i = 1; i <= options.pings; i++) {
+    Clock::time_point start = Clock::now();
+    send_string(publisher, make_property_edit(i, i, "bench_ping"));
+
+    bool answered = false;
+    while (recv_type(subscriber, "bench_pong", msg, options.timeout_ms)) {
+      if (message_uint(msg, "seq") == static_cast<uint64_t>(i)) {
+        answered = true;
+        break;
+      }
+    }
+
+    if (!answered) {
+      std::printf("ping %d timed out\n", i);
+      return;
+    }
+
+    shared.ping.add(elapsed_us(start, Clock::now()));
+  }
+}
+
+void run_edits(const Options& options, zmq::socket_t& publisher,
+               zmq::socket_t& subscriber, Shared& shared) {
+  std::string msg;
+  Clock::time_point start = Clock::now();
+
+  for (int i = 0; i < options.edits; i++) {
+    std::string edit = make_property_edit(1 + i % options.entities, i);
+    shared.edit_bytes += edit.size();
+    send_string(publisher, edit);
+  }
+
+  if (!recv_type(subscriber, "bench_edits_done", msg, options.timeout_ms)) {
+    std::printf("edits timed out, %zu of %d dispatched\n",
+                shared.edits_received.load(), options.edits);
+  }
+
+  shared.edit_duration_us = elapsed_us(start, Clock::now());
+}
+
+// the engine publishes scenes back to back, the editor parses every one
+void run_sync_burst(const Options& options, zmq::socket_t& subscriber,
+                    Shared& shared) {
+  std::string msg;
+  Clock::time_point start = Clock::now();
+  shared.phase = Phase::SyncBurst;
+
+  while (shared.burst_received < static_cast<size_t>(options.syncs) &&
+         recv_type(subscriber, "scene", msg, options.timeout_ms)) {
+    rapidjson::Document doc;
+    doc.Parse(msg.c_str());
+    shared.burst_received++;
+    shared.burst_bytes += msg.size();
+  }
+
+  shared.burst_duration_us = elapsed_us(start, Clock::now());
+}
+
+// acks every scene like the editor does, the engine measures the round trip
+void run_sync_acks(const Options& options, zmq::socket_t& publisher,
+                   zmq::socket_t& subscriber, Shared& shared) {
+  std::string msg;
+  Clock::time_point last = Clock::now();
+  shared.phase = Phase::SyncAcked;
+
+  while (shared.phase != Phase::Done) {
+    if (!recv_type(subscriber, "scene", msg, 100)) {
+      if (elapsed_us(last, Clock::now()) > options.timeout_ms * 1000.0) {
+        std::printf("acked sync timed out\n");
+        shared.phase = Phase::Done;
+      }
+      continue;
+    }
+
+    last = Clock::now();
+
+    rapidjson::Document doc;
+    doc.Parse(msg.c_str());
+    if (doc.HasMember("sync_seq")) {
+      send_string(publisher, make_simple_message("sync_ack", "sync_seq",
+                                                 doc["sync_seq"].GetUint64()));
+    }
+  }
+}
+
+void run_editor(const Options& options, Shared& shared) {
+  zmq::context_t context(1);
+  zmq::socket_t publisher(context, zmq::socket_type::pub);
+  zmq::socket_t subscriber(context, zmq::socket_type::sub);
+
+  // the throughput tests measure the consumer, not pub side drops
+  publisher.set(zmq::sockopt::sndhwm, 0);
+  publisher.bind("tcp://*:5555");
+  subscriber.bind("tcp://*:5556");
+  subscriber.set(zmq::sockopt::subscribe, "");
+
+  // the engine repeats engine_started until it sees a confirmation
+  std::string msg;
+  Clock::time_point start = Clock::now();
+  while (!shared.connected) {
+    if (elapsed_us(start, Clock::now()) > options.timeout_ms * 1000.0) {
+      std::printf("handshake timed out\n");
+      shared.phase = Phase::Done;
+      return;
+    }
+    if (recv_type(subscriber, "engine_started", msg, 100)) {
+      send_string(publisher, make_simple_message("engine_start_confirmed"));
+    }
+  }
+
+  shared.phase = Phase::Messages;
+  run_pings(options, publisher, subscriber, shared);
+  run_edits(options, publisher, subscriber, shared);
+  run_sync_burst(options, subscriber, shared);
+  run_sync_acks(options, publisher, subscriber, shared);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options = parse_options(argc, argv);
+  RemoteLogger::get().set_min_log_level(LogLevel::WARNING);
+
+  // serialization cost is not what is measured here
+  std::vector<std::string> scenes;
+  for (int i = 0; i < options.syncs; i++) {
+    scenes.push_back(make_scene(options, i + 1));
+  }
+
+  Shared shared;
+  std::thread editor(run_editor, std::cref(options), std::ref(shared));
+
+  EditorCommunication communication;
+
+  Stats edit_latency;
+  EditorEventBus::get().subscribe<EditorEvent::EntityPropertyChanged>(
+      [&](const rapidjson::Document& doc) {
+        std::string key_path = doc["key_path"].GetString();
+        if (key_path == "bench_ping") {
+          communication.send_message(make_simple_message(
+              "bench_pong", "seq", doc["entity_id"].GetUint64()));
+          return;
+        }
+
+        edit_latency.add(
+            static_cast<double>(now_us() - doc["bench_sent_us"].GetUint64()));
+        if (++shared.edits_received == static_cast<size_t>(options.edits)) {
+          communication.send_message(make_simple_message("bench_edits_done"));
+        }
+      });
+
+  Stats sync_rtt;
+  size_t syncs_sent = 0;
+  bool sync_in_flight = false;
+  bool burst_sent = false;
+  Clock::time_point sync_start;
+  EditorEventBus::get().subscribe<EditorEvent::SyncAcknowledged>(
+      [&](uint64_t sync_seq) {
+        if (sync_in_flight && sync_seq == syncs_sent) {
+          sync_rtt.add(elapsed_us(sync_start, Clock::now()));
+          sync_in_flight = false;
+        }
+      });
+
+  while (shared.phase != Phase::Done) {
+    communication.raise_events();
+    EditorEventBus::get().flush();
+    shared.connected = communication.is_connection_confirmed();
+
+    if (shared.phase == Phase::SyncBurst && !burst_sent) {
+      for (const std::string& scene : scenes) {
+        EditorEventBus::get().publish<EditorEvent::SyncEditor>(scene);
+      }
+      burst_sent = true;
+    } else if (shared.phase == Phase::SyncAcked && !sync_in_flight) {
+      if (syncs_sent == scenes.size()) {
+        shared.phase = Phase::Done;
+      } else {
+        sync_start = Clock::now();
+        sync_in_flight = true;
+        EditorEventBus::get().publish<EditorEvent::SyncEditor>(
+            scenes[syncs_sent++]);
+      }
+    }
+
+    wait_frame(options);
+  }
+
+  editor.join();
+
+  std::printf("engine -> EditorCommunication, frame %dms, scene %zu bytes\n",
+              options.frame_ms, scenes.empty() ? 0 : scenes[0].size());
+  shared.ping.print("edit -> engine -> pong");
+  print_throughput("edits editor -> engine", shared.edits_received,
+                   shared.edit_bytes, shared.edit_duration_us);
+  edit_latency.print("edit send -> dispatch");
+  print_throughput("scene burst engine -> editor", shared.burst_received,
+                   shared.burst_bytes, shared.burst_duration_us);
+  sync_rtt.print("scene -> sync_ack");
+
+  return 0;
+}
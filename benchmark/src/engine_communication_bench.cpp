@@ -0,0 +1,218 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine/engine_communication.h"
+#include "engine/engine_event.h"
+#include "ipc_bench.h"
+#include "logger.h"
+
+// Benchmarks the editor side EngineCommunication. The main thread plays the
+// editor UI loop and drives the real class, a stand-in engine connects to the
+// editor ports on a second thread and speaks the engine half of the protocol.
+
+using namespace ipc_bench;
+
+namespace {
+
+enum class Phase { Connecting, Messages, Edits, Done };
+
+// an edit burst is over once the pub side has been quiet this long
+constexpr int EDIT_IDLE_MS = 500;
+
+struct Shared {
+  std::atomic<Phase> phase{Phase::Connecting};
+  std::atomic<size_t> scenes_dispatched{0};
+
+  // written by the engine thread, read after join
+  Stats ping;
+  Stats sync_rtt;
+  Stats edit_latency;
+  size_t edits_received = 0;
+  size_t edit_bytes = 0;
+  double edit_duration_us = 0.0;
+  size_t burst_bytes = 0;
+  double burst_duration_us = 0.0;
+  size_t burst_dispatched = 0;
+};
+
+bool wait_for_ack(zmq::socket_t& subscriber, uint64_t sync_seq,
+                  int timeout_ms) {
+  std::string msg;
+  while (recv_type(subscriber, "sync_ack", msg, timeout_ms)) {
+    if (message_uint(msg, "sync_seq") == sync_seq) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void run_pings(const Options& options, zmq::socket_t& publisher,
+               zmq::socket_t& subscriber, Shared& shared) {
+  std::string msg;
+  std::string started = make_simple_message("engine_started");
+
+  for (int i = 0; i < options.pings; i++) {
+    Clock::time_point start = Clock::now();
+    send_string(publisher, started);
+
+    if (!recv_type(subscriber, "engine_start_confirmed", msg,
+                   options.timeout_ms)) {
+      std::printf("ping %d timed out\n", i);
+      return;
+    }
+
+    shared.ping.add(elapsed_us(start, Clock::now()));
+  }
+}
+
+// one snapshot in flight at a time, like Zeytin::sync_editor paces itself
+void run_sync_acks(const Options& options, zmq::socket_t& publisher,
+                   zmq::socket_t& subscriber, Shared& shared) {
+  for (int i = 1; i <= options.syncs; i++) {
+    std::string scene = make_scene(options, i);
+
+    Clock::time_point start = Clock::now();
+    send_string(publisher, scene);
+
+    if (!wait_for_ack(subscriber, i, options.timeout_ms)) {
+      std::printf("acked sync %d timed out\n", i);
+      return;
+    }
+
+    shared.sync_rtt.add(elapsed_us(start, Clock::now()));
+  }
+}
+
+// snapshots back to back, the editor is expected to conflate them
+void run_sync_burst(const Options& options, zmq::socket_t& publisher,
+                    zmq::socket_t& subscriber, Shared& shared) {
+  // sequence numbers continue after the acked test so stale acks are ignored
+  uint64_t first_seq = options.syncs + 1;
+  std::vector<std::string> scenes;
+  for (int i = 0; i < options.syncs; i++) {
+    scenes.push_back(make_scene(options, first_seq + i));
+  }
+
+  size_t dispatched_before = shared.scenes_dispatched;
+  Clock::time_point start = Clock::now();
+
+  for (const std::string& scene : scenes) {
+    shared.burst_bytes += scene.size();
+    send_string(publisher, scene);
+  }
+
+  if (!wait_for_ack(subscriber, first_seq + options.syncs - 1,
+                    options.timeout_ms)) {
+    std::printf("scene burst timed out\n");
+  }
+
+  shared.burst_duration_us = elapsed_us(start, Clock::now());
+  shared.burst_dispatched = shared.scenes_dispatched - dispatched_before;
+}
+
+// the editor publishes the edits in a single frame, drops show up as a
+// received count below the requested one
+void run_edits(const Options& options, zmq::socket_t& subscriber,
+               Shared& shared) {
+  std::string msg;
+  Clock::time_point start = Clock::now();
+  Clock::time_point last = start;
+  shared.phase = Phase::Edits;
+
+  while (shared.edits_received < static_cast<size_t>(options.edits) &&
+         recv_type(subscriber, "entity_property_changed", msg,
+                   EDIT_IDLE_MS)) {
+    last = Clock::now();
+    shared.edit_latency.add(static_cast<double>(
+        now_us() - message_uint(msg, "bench_sent_us")));
+    shared.edits_received++;
+    shared.edit_bytes += msg.size();
+  }
+
+  shared.edit_duration_us = elapsed_us(start, last);
+}
+
+void run_engine(const Options& options, Shared& shared) {
+  zmq::context_t context(1);
+  zmq::socket_t subscriber(context, zmq::socket_type::sub);
+  zmq::socket_t publisher(context, zmq::socket_type::pub);
+
+  publisher.set(zmq::sockopt::sndhwm, 0);
+  subscriber.connect("tcp://localhost:5555");
+  publisher.connect("tcp://localhost:5556");
+  subscriber.set(zmq::sockopt::subscribe, "");
+
+  // repeat engine_started until the subscription has propagated
+  std::string msg;
+  std::string started = make_simple_message("engine_started");
+  Clock::time_point start = Clock::now();
+  while (true) {
+    if (elapsed_us(start, Clock::now()) > options.timeout_ms * 1000.0) {
+      std::printf("handshake timed out\n");
+      shared.phase = Phase::Done;
+      return;
+    }
+    send_string(publisher, started);
+    if (recv_type(subscriber, "engine_start_confirmed", msg, 100)) {
+      break;
+    }
+  }
+
+  // drain confirmations for the retries above
+  while (recv_string(subscriber, msg, 100)) {
+  }
+
+  shared.phase = Phase::Messages;
+  run_pings(options, publisher, subscriber, shared);
+  run_sync_acks(options, publisher, subscriber, shared);
+  run_sync_burst(options, publisher, subscriber, shared);
+  run_edits(options, subscriber, shared);
+  shared.phase = Phase::Done;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options = parse_options(argc, argv);
+  Logger::get().set_min_log_level(LogLevel::WARNING);
+
+  Shared shared;
+  EngineCommunication communication;
+  std::thread engine(run_engine, std::cref(options), std::ref(shared));
+
+  EngineEventBus::get().subscribe<EngineEvent::SyncEditor>(
+      [&](const std::string&) { shared.scenes_dispatched++; });
+
+  bool edits_sent = false;
+  while (shared.phase != Phase::Done) {
+    communication.raise_events();
+
+    if (shared.phase == Phase::Edits && !edits_sent) {
+      for (int i = 0; i < options.edits; i++) {
+        EngineEventBus::get().publish<EngineEvent::EntityModifiedEditor>(
+            make_property_edit(1 + i % options.entities, i));
+      }
+      edits_sent = true;
+    }
+
+    wait_frame(options);
+  }
+
+  engine.join();
+
+  std::printf("editor -> EngineCommunication, frame %dms, scene %zu bytes\n",
+              options.frame_ms, make_scene(options, 1).size());
+  shared.ping.print("engine_started -> confirm");
+  shared.sync_rtt.print("scene -> sync_ack");
+  print_throughput("scene burst engine -> editor", options.syncs,
+                   shared.burst_bytes, shared.burst_duration_us);
+  std::printf("%-28s %zu of %d dispatched\n", "scene burst conflation",
+              shared.burst_dispatched, options.syncs);
+  print_throughput("edits editor -> engine", shared.edits_received,
+                   shared.edit_bytes, shared.edit_duration_us);
+  shared.edit_latency.print("edit send -> receive");
+
+  return 0;
+}
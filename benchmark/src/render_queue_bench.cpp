@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "core/raylib_wrapper.h"
+#include "render/recording_backend.h"
+#include "render/render_queue.h"
+
+// Benchmarks the RenderQueue without a window. A RecordingBackend stands in
+// for raylib, the frames are a breakout scene: a brick wall drawn into the
+// static layer like Brick does, a ball, a paddle and a score. Every frame is
+// submitted inline and threaded and the recorded draws are checked against
+// what the batching promises: a triangle run per texture, no draws for a
+// static layer that didn't change and the same frames one submit late when
+// threaded. Exits with 1 when a check fails.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  int rows = 10;
+  int columns = 20;
+  int frames = 300;  // per mode, for the timings
+};
+
+Options parse_options(int argc, char* argv[]) {
+  Options options;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string key = argv[i];
+    int value = std::atoi(argv[i + 1]);
+
+    if (key == "--rows") {
+      options.rows = value;
+    } else if (key == "--columns") {
+      options.columns = value;
+    } else if (key == "--frames") {
+      options.frames = value;
+    } else {
+      std::fprintf(stderr, "unknown option %s\n", key.c_str());
+    }
+  }
+  return options;
+}
+
+int failures = 0;
+
+void check(bool condition, const char* what, size_t value) {
+  if (!condition) failures++;
+  std::printf("  %-44s %6zu  %s\n", what, value, condition ? "ok" : "FAIL");
+}
+
+// one frame of the scene, the brick at destroyed is left out
+void queue_frame(const Options& options, int destroyed, float ball_x) {
+  RenderQueue& queue = RenderQueue::get();
+  queue.set_space(RenderQueue::Space::Screen);
+
+  for (int row = 0; row < options.rows; row++) {
+    for (int col = 0; col < options.columns; col++) {
+      if (row * options.columns + col == destroyed) continue;
+
+      Rectangle rect = {100.0f + col * 85.0f, 50.0f + row * 35.0f, 80.0f,
+                        30.0f};
+      RenderQueue::StaticScope static_scope;
+      queue.draw_rectangle(rect, RED);
+      queue.draw_rectangle_lines(rect, 2.0f, BLACK);
+      queue.draw_text(row % 3 == 0 ? "3" : "1",
+                      Vector2{rect.x + 35, rect.y + 5}, 20, WHITE);
+    }
+  }
+
+  queue.draw_circle(Vector2{ball_x, 700.0f}, 10.0f, BLACK);
+  queue.draw_rectangle(Rectangle{900.0f, 1000.0f, 150.0f, 20.0f}, BLUE);
+  queue.draw_text("Score: 120", Vector2{20.0f, 20.0f}, 40, PURPLE);
+}
+
+struct FrameResult {
+  size_t draws = 0;
+  size_t triangle_draws = 0;
+  size_t texture_switches = 0;
+  size_t static_redraws = 0;
+};
+
+FrameResult submit_frame(RecordingBackend& backend,
+                         const RenderTexture2D& target,
+                         const Camera2D& camera) {
+  backend.clear();
+  RenderQueue::get().submit(target, camera, RAYWHITE);
+
+  FrameResult result;
+  result.draws = backend.get_draws().size();
+  result.triangle_draws = backend.get_draw_count(RecordedDraw::Triangles);
+  result.texture_switches = backend.get_texture_switch_count();
+  result.static_redraws = RenderQueue::get().get_static_redraw_count();
+  return result;
+}
+
+// at most a run per texture: shapes and glyphs into the static layer, then
+// the layer and the shapes and glyphs on top of it into the target
+constexpr size_t k_first_frame_draws = 5;
+constexpr size_t k_frame_draws = 3;
+
+void run_checks(const Options& options, RecordingBackend& backend,
+                const RenderTexture2D& target, const Camera2D& camera,
+                bool threaded) {
+  RenderQueue& queue = RenderQueue::get();
+  queue.set_threaded(threaded);
+  std::printf("%s\n", threaded ? "threaded" : "inline");
+
+  // threaded, a submit draws the frame queued before it
+  if (threaded) {
+    queue_frame(options, -1, 300.0f);
+    FrameResult none = submit_frame(backend, target, camera);
+    check(none.draws == 0, "first submit draws nothing", none.draws);
+  }
+
+  queue_frame(options, -1, 310.0f);
+  FrameResult first = submit_frame(backend, target, camera);
+  check(first.draws <= k_first_frame_draws, "draws of the first frame",
+        first.draws);
+  check(first.triangle_draws == first.draws, "of them triangle runs",
+        first.triangle_draws);
+
+  queue_frame(options, -1, 320.0f);
+  FrameResult steady = submit_frame(backend, target, camera);
+  check(steady.draws == k_frame_draws, "draws of an unchanged wall",
+        steady.draws);
+  check(steady.texture_switches == k_frame_draws, "texture switches",
+        steady.texture_switches);
+  check(steady.static_redraws == 0, "static layer redraws",
+        steady.static_redraws);
+
+  // a destroyed brick redraws its region of the layer, threaded one later
+  queue_frame(options, options.columns + 1, 330.0f);
+  FrameResult hit = submit_frame(backend, target, camera);
+  queue_frame(options, options.columns + 1, 340.0f);
+  FrameResult after = submit_frame(backend, target, camera);
+  const FrameResult& redrawn = threaded ? after : hit;
+  check(redrawn.static_redraws == 1, "redraws after a destroyed brick",
+        redrawn.static_redraws);
+  check(redrawn.draws <= k_first_frame_draws, "draws of that frame",
+        redrawn.draws);
+
+  auto start = Clock::now();
+  size_t draws = 0;
+  for (int frame = 0; frame < options.frames; frame++) {
+    queue_frame(options, options.columns + 1, 350.0f + frame);
+    draws += submit_frame(backend, target, camera).draws;
+  }
+  double us = std::chrono::duration<double, std::micro>(Clock::now() - start)
+                  .count();
+  check(draws == (size_t)options.frames * k_frame_draws,
+        "draws over the timed frames", draws);
+  std::printf("  %d bricks, %.1f us per frame\n",
+              options.rows * options.columns, us / options.frames);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options = parse_options(argc, argv);
+
+  static RecordingBackend backend;
+  RenderBackend::set(&backend);
+
+  RenderTexture2D target = load_render_texture(1920, 1080);
+  Camera2D camera = {};
+  camera.zoom = 1.0f;
+
+  run_checks(options, backend, target, camera, false);
+  run_checks(options, backend, target, camera, true);
+
+  unload_render_texture(target);
+  std::printf("%s\n", failures == 0 ? "all checks passed" : "checks failed");
+  return failures == 0 ? 0 : 1;
+}
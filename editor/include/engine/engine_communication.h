@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <vector>
+#include "engine/event_channel.h"
 #include "zmq.hpp"
 
 class EngineCommunication {
@@ -19,20 +22,38 @@ public:
 
 private:
   void register_event_handlers();
+  void reactor_loop();
   void receive_messages();
-  void event_processing_loop();
+  void flush_outbox();
+  void wake_reactor();
   bool send_simple_message(const std::string &type, const std::string &key = "",
                            bool value = false);
+  void send_sync_ack(uint64_t sync_seq);
+  void process_message(const std::string &msg);
 
-  bool m_running;
+  std::atomic<bool> m_running;
   bool m_initialized;
 
   zmq::context_t m_context;
   zmq::socket_t m_publisher;
   zmq::socket_t m_subscriber;
 
-  std::thread m_receive_thread;
-  std::thread m_event_thread;
+  // all socket I/O happens on the reactor thread, other threads hand it
+  // outgoing messages through the outbox and wake it up over inproc
+  zmq::socket_t m_wakeup_receiver;
+  zmq::socket_t m_wakeup_sender;
+  std::thread m_reactor_thread;
+
+  std::mutex m_outbox_mutex;
+  std::queue<std::string> m_outbox;
+
   std::mutex m_queue_mutex;
   std::queue<std::string> m_message_queue;
+  std::atomic<bool> m_messages_pending{false};
+
+  // only the newest scene snapshot is kept, older unprocessed ones are dropped
+  std::string m_latest_scene;
+  size_t m_conflated_scenes = 0;
+
+  std::vector<EventSubscription> m_subscriptions;
 };
@@ -2,6 +2,8 @@
 
 #include <future>
 #include <string>
+#include <vector>
+#include "engine/event_channel.h"
 
 class EngineControls {
 public:
@@ -35,4 +37,6 @@ private:
   std::string m_build_details;
   std::future<void> m_build_monitor_future;
   bool m_build_monitor_active;
+
+  std::vector<EventSubscription> m_subscriptions;
 };
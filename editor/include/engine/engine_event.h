@@ -1,10 +1,8 @@
-#include <algorithm>
-#include <any>
-#include <functional>
-#include <map>
-#include <mutex>
-#include <shared_mutex>
-#include <vector>
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "engine/event_channel.h"
 
 enum class EngineEvent {
   EngineStarted,
@@ -17,9 +15,41 @@ enum class EngineEvent {
   UnPausePlayMode,
   ExitPlayMode,
   SyncEditor,
+  SyncConsumed,
   WindowStateChanged,
 };
 
+// payload carried by each event, publishers and subscribers are checked
+// against it at compile time
+template <EngineEvent E>
+struct EngineEventPayload;
+
+#define ENGINE_EVENT_PAYLOAD(event, payload) \
+  template <>                                \
+  struct EngineEventPayload<EngineEvent::event> { using type = payload; }
+
+ENGINE_EVENT_PAYLOAD(EngineStarted, bool);
+ENGINE_EVENT_PAYLOAD(EngineSendScene, std::string);
+ENGINE_EVENT_PAYLOAD(KillEngine, bool);
+ENGINE_EVENT_PAYLOAD(EngineStopped, bool);
+ENGINE_EVENT_PAYLOAD(EntityModifiedEditor, std::string);
+ENGINE_EVENT_PAYLOAD(EnterPlayMode, bool);
+ENGINE_EVENT_PAYLOAD(PausePlayMode, bool);
+ENGINE_EVENT_PAYLOAD(UnPausePlayMode, bool);
+ENGINE_EVENT_PAYLOAD(ExitPlayMode, bool);
+ENGINE_EVENT_PAYLOAD(SyncEditor, std::string);
+ENGINE_EVENT_PAYLOAD(SyncConsumed, uint64_t);  // sync_seq of the snapshot
+ENGINE_EVENT_PAYLOAD(WindowStateChanged, std::string);
+
+#undef ENGINE_EVENT_PAYLOAD
+
+template <EngineEvent E>
+using EngineEventPayloadT = typename EngineEventPayload<E>::type;
+
+template <EngineEvent E>
+using EngineEventCallback =
+    typename EventChannel<EngineEventPayloadT<E>>::Callback;
+
 class EngineEventBus {
 public:
   static EngineEventBus &get() {
@@ -27,55 +57,24 @@ public:
     return instance;
   }
 
-  template <typename T>
-  void publish(EngineEvent event, const T &data) {
-    std::shared_lock<std::shared_mutex> lock(m_mutex);
-
-    auto it = m_subscribers.find(event);
-    if (it != m_subscribers.end()) {
-      auto callbacks = it->second;
-      lock.unlock();
-
-      for (auto &callback : callbacks) {
-        if (auto func =
-                std::any_cast<std::function<void(const T &)>>(&callback)) {
-          (*func)(data);
-        }
-      }
-    }
+  template <EngineEvent E>
+  void publish(const EngineEventPayloadT<E> &data) {
+    channel<E>().publish(data);
   }
 
-  template <typename T>
-  void subscribe(EngineEvent event, std::function<void(const T &)> callback) {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
-    m_subscribers[event].push_back(std::any(callback));
-  }
-
-  template <typename T>
-  void unsubscribe(EngineEvent event,
-                   const std::function<void(const T &)> *callback_ptr) {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
-
-    auto it = m_subscribers.find(event);
-    if (it != m_subscribers.end()) {
-      auto &callbacks = it->second;
-      callbacks.erase(
-          std::remove_if(
-              callbacks.begin(), callbacks.end(),
-              [callback_ptr](const std::any &item) {
-                auto func =
-                    std::any_cast<std::function<void(const T &)>>(&item);
-                return func &&
-                       func->target_type() == callback_ptr->target_type();
-              }),
-          callbacks.end());
-    }
+  template <EngineEvent E>
+  EventSubscription subscribe(EngineEventCallback<E> callback) {
+    return channel<E>().subscribe(std::move(callback));
   }
 
 private:
   EngineEventBus() = default;
   ~EngineEventBus() = default;
 
-  std::map<EngineEvent, std::vector<std::any>> m_subscribers;
-  std::shared_mutex m_mutex;
+  // one channel per event, resolved at compile time
+  template <EngineEvent E>
+  EventChannel<EngineEventPayloadT<E>> &channel() {
+    static EventChannel<EngineEventPayloadT<E>> instance;
+    return instance;
+  }
 };
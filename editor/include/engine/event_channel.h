@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "utility/inline_function.h"
+
+class EventChannelBase {
+public:
+  virtual ~EventChannelBase() = default;
+  virtual void unsubscribe(uint64_t id) = 0;
+};
+
+// returned by subscribe, an empty handle is a no-op to unsubscribe
+class EventSubscription {
+public:
+  EventSubscription() = default;
+  EventSubscription(EventChannelBase *channel, uint64_t id)
+      : m_channel(channel), m_id(id) {}
+
+  void unsubscribe() {
+    if (m_channel) {
+      m_channel->unsubscribe(m_id);
+      m_channel = nullptr;
+    }
+  }
+
+  explicit operator bool() const { return m_channel != nullptr; }
+
+private:
+  EventChannelBase *m_channel = nullptr;
+  uint64_t m_id = 0;
+};
+
+// Subscriber list for a single payload type. Subscribing copies the list,
+// publishing only takes a reference to the current one, so publish neither
+// allocates nor blocks on other publishers and handlers may (un)subscribe
+// while being called. A handler removed during a publish on another thread
+// can still see that last call.
+template <typename Payload>
+class EventChannel : public EventChannelBase {
+public:
+  using Callback = InlineFunction<void(const Payload &)>;
+
+  EventChannel() : m_slots(std::make_shared<const Slots>()) {}
+
+  EventSubscription subscribe(Callback callback) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    auto slots = std::make_shared<Slots>(*std::atomic_load(&m_slots));
+    uint64_t id = ++m_next_id;
+    slots->push_back({id, std::move(callback)});
+    std::atomic_store(&m_slots, std::shared_ptr<const Slots>(slots));
+
+    return EventSubscription(this, id);
+  }
+
+  void unsubscribe(uint64_t id) override {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    auto slots = std::make_shared<Slots>(*std::atomic_load(&m_slots));
+    for (auto it = slots->begin(); it != slots->end(); ++it) {
+      if (it->id == id) {
+        slots->erase(it);
+        break;
+      }
+    }
+    std::atomic_store(&m_slots, std::shared_ptr<const Slots>(slots));
+  }
+
+  void publish(const Payload &payload) const {
+    std::shared_ptr<const Slots> slots = std::atomic_load(&m_slots);
+    for (const Slot &slot : *slots) {
+      slot.callback(payload);
+    }
+  }
+
+private:
+  struct Slot {
+    uint64_t id;
+    Callback callback;
+  };
+  using Slots = std::vector<Slot>;
+
+  std::shared_ptr<const Slots> m_slots;
+  std::mutex m_write_mutex;
+  uint64_t m_next_id = 0;
+};
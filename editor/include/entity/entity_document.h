@@ -8,16 +8,20 @@ class EntityDocument final {
 public:
   inline EntityDocument(std::string name) : m_name(name) {}
   inline EntityDocument(rapidjson::Document document, std::string name)
-      : m_document(std::move(document)), m_name(name) {}
+      : m_document(std::move(document)), m_name(name) {
+    cache_entity_id();
+  }
 
   inline rapidjson::Document &get_document() { return m_document; }
   inline const rapidjson::Document &get_document() const { return m_document; }
 
   inline void set_document(rapidjson::Document new_doc) {
     m_document = std::move(new_doc);
+    cache_entity_id();
   }
 
   inline const std::string &get_name() const { return m_name; }
+  inline uint64_t get_entity_id() const { return m_entity_id; }
 
   inline void mark_as_dead() { m_dead = true; }
   inline bool is_dead() const { return m_dead; }
@@ -32,7 +36,10 @@ public:
   std::string as_string() const;
 
 private:
+  void cache_entity_id();
+
   std::string m_name;
   rapidjson::Document m_document;
+  uint64_t m_entity_id = 0;
   bool m_dead = false;
 };
@@ -1,21 +1,47 @@
 #pragma once
 
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "engine/event_channel.h"
 #include "entity_document.h"
 
 class EntityList final {
 public:
   EntityList();
-
-  ~EntityList() { clean_backup_entities(); }
+  ~EntityList();
 
   inline std::vector<EntityDocument> &get_entities() { return m_entities; }
   std::string as_string() const;
 
+  EntityDocument *find_entity(uint64_t entity_id);
+  EntityDocument &add_entity(EntityDocument entity);
+  void remove_entity(uint64_t entity_id);
+
+  // called by the UI thread at frame start, applies the newest parsed sync
+  // and acks it to the engine, a stale one is acked without being applied
+  void swap_synced_entities();
+
 private:
+  struct ParsedSync {
+    uint64_t generation = 0;
+    std::optional<uint64_t> sync_seq;
+    std::vector<std::pair<uint64_t, rapidjson::Document>> entities;
+  };
+
   void register_event_handlers();
-  void sync_entities_from_document(const rapidjson::Document &document);
+  void index_entity(size_t index);
+
+  void submit_sync(std::string msg);
+  void sync_worker_loop();
+  static bool parse_sync(const std::string &msg, ParsedSync &parsed);
+  void apply_sync(ParsedSync &parsed);
 
   void load_entity_from_file(const std::filesystem::path &path);
   void load_entities(const std::filesystem::path &path);
@@ -32,4 +58,18 @@ private:
   bool m_is_synced_once = false;
 
   std::vector<EntityDocument> m_entities;
+  std::unordered_map<uint64_t, size_t> m_entity_index;  // entity_id -> index
+
+  // syncs are parsed on m_sync_worker into a back buffer, the generation is
+  // bumped on play mode changes so stale runtime state is never swapped in
+  uint64_t m_sync_generation = 0;
+  bool m_sync_running = true;
+  std::thread m_sync_worker;
+  std::mutex m_sync_mutex;
+  std::condition_variable m_sync_cv;
+  std::string m_pending_sync;
+  uint64_t m_pending_sync_generation = 0;
+  std::optional<ParsedSync> m_parsed_sync;
+
+  std::vector<EventSubscription> m_subscriptions;
 };
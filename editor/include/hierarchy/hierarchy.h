@@ -3,12 +3,12 @@
 #include <map>
 #include <vector>
 #include "entity/entity_document.h"
+#include "entity/entity_list.h"
 #include "variant/variant_document.h"
 
 class Hierarchy final {
 public:
-  Hierarchy(std::vector<EntityDocument> &entities,
-            std::vector<VariantDocument> &variants);
+  Hierarchy(EntityList &entity_list, std::vector<VariantDocument> &variants);
   void update();
 
 private:
@@ -71,6 +71,6 @@ private:
   void save_all_entities();
   void subscribe_events();
 
-  std::vector<EntityDocument> &m_entities;
+  EntityList &m_entity_list;
   std::vector<VariantDocument> &m_variants;
 };
@@ -1,5 +1,5 @@
 #include "engine/engine_communication.h"
-#include <chrono>
+#include <vector>
 #include "engine/engine_event.h"
 #include "logger.h"
 #include "rapidjson/document.h"
@@ -7,50 +7,69 @@
 #include "rapidjson/writer.h"
 #include "zmq.hpp"
 
+namespace {
+constexpr const char *WAKEUP_ADDRESS = "inproc://engine_communication_wakeup";
+
+// engine writes "type" as the first member of every scene snapshot, which lets
+// the reactor thread conflate snapshots without parsing them
+constexpr const char *SCENE_SNAPSHOT_PREFIX = "{\"type\":\"scene\"";
+
+bool is_scene_snapshot(const std::string &msg) {
+  return msg.compare(0, strlen(SCENE_SNAPSHOT_PREFIX), SCENE_SNAPSHOT_PREFIX) ==
+         0;
+}
+}  // namespace
+
 EngineCommunication::EngineCommunication()
     : m_running(false),
       m_initialized(false),
       m_context(1),
       m_publisher(m_context, zmq::socket_type::pub),
-      m_subscriber(m_context, zmq::socket_type::sub) {
+      m_subscriber(m_context, zmq::socket_type::sub),
+      m_wakeup_receiver(m_context, zmq::socket_type::pair),
+      m_wakeup_sender(m_context, zmq::socket_type::pair) {
   initialize();
   register_event_handlers();
 }
 
-EngineCommunication::~EngineCommunication() { shutdown(); }
+EngineCommunication::~EngineCommunication() {
+  for (auto &subscription : m_subscriptions) {
+    subscription.unsubscribe();
+  }
+  shutdown();
+}
 
 void EngineCommunication::register_event_handlers() {
-  EngineEventBus::get().subscribe<const std::string &>(
-      EngineEvent::EngineSendScene,
-      [this](const auto &msg) { send_message(msg); });
+  auto &bus = EngineEventBus::get();
 
-  EngineEventBus::get().subscribe<const std::string &>(
-      EngineEvent::EntityModifiedEditor,
-      [this](const std::string &msg) { send_message(msg); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::EngineSendScene>(
+      [this](const std::string &msg) { send_message(msg); }));
 
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::EnterPlayMode, [this](bool paused) {
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::SyncConsumed>(
+      [this](uint64_t sync_seq) { send_sync_ack(sync_seq); }));
+
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::EntityModifiedEditor>(
+      [this](const std::string &msg) { send_message(msg); }));
+
+  m_subscriptions.push_back(
+      bus.subscribe<EngineEvent::EnterPlayMode>([this](bool paused) {
         send_simple_message("enter_play_mode", "is_paused", paused);
-      });
+      }));
 
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::ExitPlayMode,
-      [this](bool) { send_simple_message("exit_play_mode"); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::ExitPlayMode>(
+      [this](bool) { send_simple_message("exit_play_mode"); }));
 
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::PausePlayMode,
-      [this](bool) { send_simple_message("pause_play_mode"); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::PausePlayMode>(
+      [this](bool) { send_simple_message("pause_play_mode"); }));
 
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::UnPausePlayMode,
-      [this](bool) { send_simple_message("unpause_play_mode"); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::UnPausePlayMode>(
+      [this](bool) { send_simple_message("unpause_play_mode"); }));
 
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::KillEngine, [this](bool) { send_simple_message("die"); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::KillEngine>(
+      [this](bool) { send_simple_message("die"); }));
 
-  EngineEventBus::get().subscribe<const std::string &>(
-      EngineEvent::WindowStateChanged,
-      [this](const std::string &message) { send_message(message); });
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::WindowStateChanged>(
+      [this](const std::string &message) { send_message(message); }));
 }
 
 bool EngineCommunication::initialize() {
@@ -61,11 +80,11 @@ bool EngineCommunication::initialize() {
     m_subscriber.bind("tcp://*:5556");
     m_subscriber.set(zmq::sockopt::subscribe, "");
 
+    m_wakeup_receiver.bind(WAKEUP_ADDRESS);
+    m_wakeup_sender.connect(WAKEUP_ADDRESS);
+
     m_running = true;
-    m_receive_thread =
-        std::thread(&EngineCommunication::receive_messages, this);
-    m_event_thread =
-        std::thread(&EngineCommunication::event_processing_loop, this);
+    m_reactor_thread = std::thread(&EngineCommunication::reactor_loop, this);
 
     m_initialized = true;
     return true;
@@ -75,91 +94,104 @@ bool EngineCommunication::initialize() {
   }
 }
 
-void EngineCommunication::event_processing_loop() {
-  while (m_running) {
-    raise_events();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+void EngineCommunication::raise_events() {
+  if (!m_messages_pending.exchange(false)) {
+    return;
   }
-}
 
-void EngineCommunication::raise_events() {
   std::queue<std::string> messages;
+  std::string latest_scene;
+  size_t conflated_scenes = 0;
 
   {
     std::lock_guard<std::mutex> lock(m_queue_mutex);
     messages.swap(m_message_queue);
+    latest_scene.swap(m_latest_scene);
+    std::swap(conflated_scenes, m_conflated_scenes);
   }
 
   while (!messages.empty()) {
-    const std::string &msg = messages.front();
+    process_message(messages.front());
+    messages.pop();
+  }
 
-    if (msg.empty()) {
-      continue;
-    }
+  if (conflated_scenes > 0) {
+    log_trace() << "Dropped " << conflated_scenes
+                << " outdated scene snapshots" << std::endl;
+  }
 
-    rapidjson::Document doc;
-    doc.Parse(msg.c_str());
+  if (!latest_scene.empty()) {
+    process_message(latest_scene);
+  }
+}
 
-    if (doc.HasParseError()) {
-      log_error() << "Failed to parse message: " << msg.substr(0, 100)
-                  << (msg.length() > 100 ? "..." : "") << std::endl;
-      log_error() << "Parse error code: " << doc.GetParseError()
-                  << " at offset " << doc.GetErrorOffset() << std::endl;
-      messages.pop();
-      continue;
-    }
+void EngineCommunication::process_message(const std::string &msg) {
+  if (msg.empty()) {
+    return;
+  }
 
-    if (!doc.IsObject()) {
-      log_error() << "Message is not a valid JSON object" << std::endl;
-      messages.pop();
-      continue;
-    }
+  // snapshots go to the entity list unparsed, its sync worker parses them
+  if (is_scene_snapshot(msg)) {
+    EngineEventBus::get().publish<EngineEvent::SyncEditor>(msg);
+    return;
+  }
 
-    if (!doc.HasMember("type") || !doc["type"].IsString()) {
-      log_error() << "Message missing 'type' field or not a string"
-                  << std::endl;
-      messages.pop();
-      continue;
-    }
+  rapidjson::Document doc;
+  doc.Parse(msg.c_str());
+
+  if (doc.HasParseError()) {
+    log_error() << "Failed to parse message: " << msg.substr(0, 100)
+                << (msg.length() > 100 ? "..." : "") << std::endl;
+    log_error() << "Parse error code: " << doc.GetParseError()
+                << " at offset " << doc.GetErrorOffset() << std::endl;
+    return;
+  }
 
-    const std::string type = doc["type"].GetString();
+  if (!doc.IsObject()) {
+    log_error() << "Message is not a valid JSON object" << std::endl;
+    return;
+  }
 
-    if (type.empty()) {
-      continue;
-    }
+  if (!doc.HasMember("type") || !doc["type"].IsString()) {
+    log_error() << "Message missing 'type' field or not a string" << std::endl;
+    return;
+  }
+
+  const std::string type = doc["type"].GetString();
 
-    if (type == "scene") {
-      EngineEventBus::get().publish<std::string>(EngineEvent::SyncEditor, msg);
-    } else if (type == "engine_started") {
-      send_simple_message("engine_start_confirmed");
-      EngineEventBus::get().publish<bool>(EngineEvent::EngineStarted, true);
-    } else if (type == "engine_shutdown") {
-      log_info() << "Engine shutdown" << std::endl;
-      EngineEventBus::get().publish<bool>(EngineEvent::EngineStopped, true);
-    } else if (type == "log_message") {
-      if (doc.HasMember("level") && doc.HasMember("message")) {
-        assert(doc["level"].IsString());
-        assert(doc["message"].IsString());
-
-        std::string level = doc["level"].GetString();
-        std::string msg = doc["message"].GetString();
-
-        if (level == "INFO") {
-          Logger::get().info() << "[ENGINE] " << msg;
-        } else if (level == "TRACE") {
-          Logger::get().trace() << "[ENGINE] " << msg;
-        } else if (level == "WARNING") {
-          Logger::get().warning() << "[ENGINE] " << msg;
-        } else if (level == "ERROR") {
-          Logger::get().error() << "[ENGINE] " << msg;
-        }
+  if (type.empty()) {
+    return;
+  }
+
+  if (type == "scene") {
+    EngineEventBus::get().publish<EngineEvent::SyncEditor>(msg);
+  } else if (type == "engine_started") {
+    send_simple_message("engine_start_confirmed");
+    EngineEventBus::get().publish<EngineEvent::EngineStarted>(true);
+  } else if (type == "engine_shutdown") {
+    log_info() << "Engine shutdown" << std::endl;
+    EngineEventBus::get().publish<EngineEvent::EngineStopped>(true);
+  } else if (type == "log_message") {
+    if (doc.HasMember("level") && doc.HasMember("message")) {
+      assert(doc["level"].IsString());
+      assert(doc["message"].IsString());
+
+      std::string level = doc["level"].GetString();
+      std::string msg = doc["message"].GetString();
+
+      if (level == "INFO") {
+        Logger::get().info() << "[ENGINE] " << msg;
+      } else if (level == "TRACE") {
+        Logger::get().trace() << "[ENGINE] " << msg;
+      } else if (level == "WARNING") {
+        Logger::get().warning() << "[ENGINE] " << msg;
+      } else if (level == "ERROR") {
+        Logger::get().error() << "[ENGINE] " << msg;
       }
-    } else {
-      log_warning() << "Unknown message received from engine: " << type
-                    << std::endl;
     }
-
-    messages.pop();
+  } else {
+    log_warning() << "Unknown message received from engine: " << type
+                  << std::endl;
   }
 }
 
@@ -167,13 +199,10 @@ void EngineCommunication::shutdown() {
   if (!m_initialized) return;
 
   m_running = false;
+  wake_reactor();
 
-  if (m_receive_thread.joinable()) {
-    m_receive_thread.join();
-  }
-
-  if (m_event_thread.joinable()) {
-    m_event_thread.join();
+  if (m_reactor_thread.joinable()) {
+    m_reactor_thread.join();
   }
 
   m_initialized = false;
@@ -190,17 +219,44 @@ bool EngineCommunication::send_message(const std::string &json) {
     return false;
   }
 
-  zmq::message_t message(json.size());
-  if (message.size() != json.size()) {
-    log_error() << "Failed to allocate message of size " << json.size()
-                << std::endl;
-    return false;
+  bool was_empty;
+  {
+    std::lock_guard<std::mutex> lock(m_outbox_mutex);
+    was_empty = m_outbox.empty();
+    m_outbox.push(json);
   }
 
-  memcpy(message.data(), json.data(), json.size());
+  if (was_empty) {
+    wake_reactor();
+  }
+  return true;
+}
+
+void EngineCommunication::flush_outbox() {
+  std::queue<std::string> outbox;
+
+  {
+    std::lock_guard<std::mutex> lock(m_outbox_mutex);
+    outbox.swap(m_outbox);
+  }
 
-  auto result = m_publisher.send(message, zmq::send_flags::none);
-  return result.has_value();
+  while (!outbox.empty()) {
+    const std::string &json = outbox.front();
+
+    zmq::message_t message(json.data(), json.size());
+    if (!m_publisher.send(message, zmq::send_flags::none)) {
+      log_error() << "Failed to send message of size " << json.size()
+                  << std::endl;
+    }
+
+    outbox.pop();
+  }
+}
+
+void EngineCommunication::wake_reactor() {
+  // pair sockets are not thread safe, senders share the outbox lock
+  std::lock_guard<std::mutex> lock(m_outbox_mutex);
+  m_wakeup_sender.send(zmq::message_t(), zmq::send_flags::dontwait);
 }
 
 bool EngineCommunication::send_simple_message(const std::string &type,
@@ -232,36 +288,79 @@ bool EngineCommunication::send_simple_message(const std::string &type,
   return send_message(buffer.GetString());
 }
 
+void EngineCommunication::send_sync_ack(uint64_t sync_seq) {
+  rapidjson::Document msg;
+  msg.SetObject();
+
+  msg.AddMember("type", "sync_ack", msg.GetAllocator());
+  msg.AddMember("sync_seq", sync_seq, msg.GetAllocator());
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  msg.Accept(writer);
+
+  send_message(buffer.GetString());
+}
+
 bool EngineCommunication::is_engine_connected() const { return m_initialized; }
 
-void EngineCommunication::receive_messages() {
+void EngineCommunication::reactor_loop() {
+  zmq::pollitem_t items[] = {
+      {static_cast<void *>(m_subscriber), 0, ZMQ_POLLIN, 0},
+      {static_cast<void *>(m_wakeup_receiver), 0, ZMQ_POLLIN, 0}};
+
   while (m_running) {
-    zmq::pollitem_t items[] = {
-        {static_cast<void *>(m_subscriber), 0, ZMQ_POLLIN, 0}};
+    try {
+      zmq::poll(items, 2);  // blocks until a message or a wakeup arrives
+    } catch (const zmq::error_t &e) {
+      if (e.num() == EINTR) continue;
+      log_error() << "ZeroMQ poll error: " << e.what() << std::endl;
+      break;
+    }
 
-    zmq::poll(items, 1, std::chrono::milliseconds(100));
+    if (items[1].revents & ZMQ_POLLIN) {
+      zmq::message_t wakeup;
+      while (m_wakeup_receiver.recv(wakeup, zmq::recv_flags::dontwait)) {
+      }
+      flush_outbox();
+    }
 
     if (items[0].revents & ZMQ_POLLIN) {
-      zmq::message_t message;
-      auto result = m_subscriber.recv(message, zmq::recv_flags::none);
-
-      if (result.has_value() && message.size() > 0) {
-        if (message.data() != nullptr) {
-          std::string message_str(static_cast<char *>(message.data()),
-                                  message.size());
-
-          if (!message_str.empty()) {
-            std::lock_guard<std::mutex> lock(m_queue_mutex);
-            m_message_queue.push(message_str);
-          } else {
-            log_error() << "Received empty message" << std::endl;
-          }
-        } else {
-          log_error() << "Received message with null data" << std::endl;
-        }
-      }
+      receive_messages();
     }
+  }
+
+  flush_outbox();  // deliver whatever was sent right before shutdown
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+void EngineCommunication::receive_messages() {
+  std::vector<std::string> received;
+  zmq::message_t message;
+
+  while (m_subscriber.recv(message, zmq::recv_flags::dontwait)) {
+    if (message.size() == 0 || message.data() == nullptr) {
+      log_error() << "Received empty message" << std::endl;
+      continue;
+    }
+
+    received.emplace_back(static_cast<char *>(message.data()), message.size());
+  }
+
+  if (received.empty()) {
+    return;
   }
+
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    for (auto &message_str : received) {
+      if (is_scene_snapshot(message_str)) {
+        if (!m_latest_scene.empty()) m_conflated_scenes++;
+        m_latest_scene = std::move(message_str);
+      } else {
+        m_message_queue.push(std::move(message_str));
+      }
+    }
+  }
+
+  m_messages_pending = true;  // picked up by the UI thread at frame start
 }
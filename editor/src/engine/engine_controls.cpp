@@ -21,29 +21,34 @@ EngineControls::EngineControls()
       m_is_engine_starting(false),
       m_build_status(BuildStatus::None),
       m_build_monitor_active(false) {
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::EngineStarted, [this](const bool &success) {
-        if (success) {
-          m_is_running = true;
-          m_is_engine_starting = false;
-          m_build_status = BuildStatus::None;
-          log_info() << "Engine started successfully." << std::endl;
-        }
-      });
+  m_subscriptions.push_back(
+      EngineEventBus::get().subscribe<EngineEvent::EngineStarted>(
+          [this](bool success) {
+            if (success) {
+              m_is_running = true;
+              m_is_engine_starting = false;
+              m_build_status = BuildStatus::None;
+              log_info() << "Engine started successfully." << std::endl;
+            }
+          }));
 
-  EngineEventBus::get().subscribe<bool>(EngineEvent::EngineStopped,
-                                        [this](auto _) {
-                                          if (m_is_play_mode) {
-                                            exit_play_mode();
-                                          }
-                                          m_is_running = false;
-                                          m_is_engine_starting = false;
-                                        });
+  m_subscriptions.push_back(
+      EngineEventBus::get().subscribe<EngineEvent::EngineStopped>([this](bool) {
+        if (m_is_play_mode) {
+          exit_play_mode();
+        }
+        m_is_running = false;
+        m_is_engine_starting = false;
+      }));
 
   write_status_file("none", "Editor started");
 }
 
 EngineControls::~EngineControls() {
+  for (auto &subscription : m_subscriptions) {
+    subscription.unsubscribe();
+  }
+
   m_build_monitor_active = false;
   if (m_build_monitor_future.valid()) {
     m_build_monitor_future.wait();
@@ -157,9 +162,9 @@ void EngineControls::render_play_controls() {
     if (ImGui::Button("Pause")) {
       m_is_paused = !m_is_paused;
       if (m_is_paused) {
-        EngineEventBus::get().publish<bool>(EngineEvent::PausePlayMode, true);
+        EngineEventBus::get().publish<EngineEvent::PausePlayMode>(true);
       } else {
-        EngineEventBus::get().publish<bool>(EngineEvent::UnPausePlayMode, true);
+        EngineEventBus::get().publish<EngineEvent::UnPausePlayMode>(true);
       }
     }
 
@@ -387,17 +392,17 @@ void EngineControls::kill_engine() {
   m_is_paused = false;
   m_is_engine_starting = false;
 
-  EngineEventBus::get().publish<bool>(EngineEvent::KillEngine, true);
+  EngineEventBus::get().publish<EngineEvent::KillEngine>(true);
 }
 
 void EngineControls::enter_play_mode() {
-  EngineEventBus::get().publish<bool>(EngineEvent::EnterPlayMode, m_is_paused);
+  EngineEventBus::get().publish<EngineEvent::EnterPlayMode>(m_is_paused);
 }
 
 void EngineControls::exit_play_mode() {
   m_is_play_mode = false;
   m_is_paused = false;
-  EngineEventBus::get().publish<bool>(EngineEvent::ExitPlayMode, true);
+  EngineEventBus::get().publish<EngineEvent::ExitPlayMode>(true);
 }
 
 static void write_status_file(const std::string &status,
@@ -62,6 +62,8 @@ void EntityDocument::load_from_file() {
     log_error() << "JSON parse error at offset " << m_document.GetErrorOffset()
                 << ": " << m_document.GetParseError() << std::endl;
   }
+
+  cache_entity_id();
 }
 
 void EntityDocument::save_to_file(const std::filesystem::path &path) const {
@@ -114,6 +116,8 @@ void EntityDocument::load_from_file(const std::filesystem::path &path) {
     log_error() << "JSON parse error at offset " << m_document.GetErrorOffset()
                 << ": " << m_document.GetParseError() << std::endl;
   }
+
+  cache_entity_id();
 }
 
 void EntityDocument::delete_entity_file() {
@@ -121,3 +125,12 @@ void EntityDocument::delete_entity_file() {
 
   std::filesystem::remove(path);
 }
+
+void EntityDocument::cache_entity_id() {
+  if (m_document.IsObject() && m_document.HasMember("entity_id") &&
+      m_document["entity_id"].IsUint64()) {
+    m_entity_id = m_document["entity_id"].GetUint64();
+  } else {
+    m_entity_id = 0;
+  }
+}
@@ -14,60 +14,71 @@ constexpr const char *ENTITY_EXTENSION = ".entity";
 EntityList::EntityList() {
   load_entities(ResourceManager::get().get_entities_path());
   register_event_handlers();
+  m_sync_worker = std::thread(&EntityList::sync_worker_loop, this);
+}
+
+EntityList::~EntityList() {
+  for (auto &subscription : m_subscriptions) {
+    subscription.unsubscribe();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_sync_mutex);
+    m_sync_running = false;
+  }
+  m_sync_cv.notify_one();
+
+  if (m_sync_worker.joinable()) {
+    m_sync_worker.join();
+  }
+
+  clean_backup_entities();
 }
 
 void EntityList::register_event_handlers() {
-  EngineEventBus::get().subscribe<bool>(
-      EngineEvent::EngineStarted, [this](auto _) {
+  auto &bus = EngineEventBus::get();
+
+  m_subscriptions.push_back(
+      bus.subscribe<EngineEvent::EngineStarted>([this](bool) {
         std::string scene = as_string();
         if (!scene.empty()) {
-          EngineEventBus::get().publish<const std::string &>(
-              EngineEvent::EngineSendScene, scene);
+          EngineEventBus::get().publish<EngineEvent::EngineSendScene>(scene);
         } else {
           log_warning() << "Empty scene will not be sent to the engine"
                         << std::endl;
         }
-      });
+      }));
 
-  EngineEventBus::get().subscribe<std::string>(
-      EngineEvent::SyncEditor, [this](auto msg) {
+  m_subscriptions.push_back(bus.subscribe<EngineEvent::SyncEditor>(
+      [this](const std::string &msg) {
         if (should_sync_runtime()) {
-          rapidjson::Document doc;
-          doc.Parse(msg.c_str());
-
-          if (doc.HasParseError()) {
-            return;
-          }
-
-          sync_entities_from_document(doc);
-          if (!m_is_synced_once) {
-            m_is_synced_once = true;
-            log_info() << "Initial sync with runtime" << std::endl;
-          }
-
+          submit_sync(msg);
         } else {
           log_warning() << "EDITOR: Sync recevied but ignored" << std::endl;
         }
-      });
-
-  EngineEventBus::get().subscribe<bool>(EngineEvent::EnterPlayMode,
-                                        [this](auto) {
-                                          m_is_play_mode = true;
-                                          backup_entities();
-                                        });
-
-  EngineEventBus::get().subscribe<bool>(EngineEvent::ExitPlayMode,
-                                        [this](bool) {
-                                          m_is_play_mode = false;
-                                          load_entities(BACKUP_DIR);
-                                          clean_backup_entities();
-                                        });
-
-  EngineEventBus::get().subscribe<bool>(EngineEvent::EngineStopped,
-                                        [this](bool) {
-                                          m_is_play_mode = false;
-                                          m_is_synced_once = false;
-                                        });
+      }));
+
+  m_subscriptions.push_back(
+      bus.subscribe<EngineEvent::EnterPlayMode>([this](bool) {
+        m_is_play_mode = true;
+        m_sync_generation++;
+        backup_entities();
+      }));
+
+  m_subscriptions.push_back(
+      bus.subscribe<EngineEvent::ExitPlayMode>([this](bool) {
+        m_is_play_mode = false;
+        m_sync_generation++;
+        load_entities(BACKUP_DIR);
+        clean_backup_entities();
+      }));
+
+  m_subscriptions.push_back(
+      bus.subscribe<EngineEvent::EngineStopped>([this](bool) {
+        m_is_play_mode = false;
+        m_is_synced_once = false;
+        m_sync_generation++;
+      }));
 }
 
 std::string EntityList::as_string() const {
@@ -119,25 +130,70 @@ std::string EntityList::as_string() const {
   return std::string(buffer.GetString(), buffer.GetSize());
 }
 
-void EntityList::sync_entities_from_document(
-    const rapidjson::Document &document) {
-  if (!document.IsObject()) {
-    return;
+void EntityList::submit_sync(std::string msg) {
+  {
+    std::lock_guard<std::mutex> lock(m_sync_mutex);
+    m_pending_sync = std::move(msg);  // an unparsed older sync is superseded
+    m_pending_sync_generation = m_sync_generation;
+  }
+  m_sync_cv.notify_one();
+}
+
+void EntityList::sync_worker_loop() {
+  while (true) {
+    ParsedSync parsed;
+    std::string msg;
+
+    {
+      std::unique_lock<std::mutex> lock(m_sync_mutex);
+      m_sync_cv.wait(lock, [this] {
+        return !m_sync_running || !m_pending_sync.empty();
+      });
+
+      if (!m_sync_running) {
+        return;
+      }
+
+      msg.swap(m_pending_sync);
+      parsed.generation = m_pending_sync_generation;
+    }
+
+    if (!parse_sync(msg, parsed)) {
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sync_mutex);
+    m_parsed_sync = std::move(parsed);
+  }
+}
+
+bool EntityList::parse_sync(const std::string &msg, ParsedSync &parsed) {
+  rapidjson::Document document;
+  document.Parse(msg.c_str());
+
+  if (document.HasParseError() || !document.IsObject()) {
+    return false;
+  }
+
+  if (document.HasMember("sync_seq") && document["sync_seq"].IsUint64()) {
+    parsed.sync_seq = document["sync_seq"].GetUint64();
   }
 
   if (!document.HasMember("entities")) {
     log_error() << "Received sync message does not have 'entities' member"
                 << std::endl;
-    return;
+    return false;
   }
 
   if (!document["entities"].IsArray()) {
     log_error() << "Received sync message 'entities' is not an array"
                 << std::endl;
-    return;
+    return false;
   }
 
   const auto &entities = document["entities"].GetArray();
+  parsed.entities.reserve(entities.Size());
+
   for (const auto &entity : entities) {
     if (!entity.HasMember("entity_id") || !entity["entity_id"].IsUint64()) {
       log_error() << "Entity missing required 'entity_id' field" << std::endl;
@@ -149,25 +205,97 @@ void EntityList::sync_entities_from_document(
       continue;
     }
 
-    uint64_t entity_id = entity["entity_id"].GetUint64();
-    bool found = false;
-
-    for (auto &entity_doc : m_entities) {
-      const auto &existing_doc = entity_doc.get_document();
-      if (existing_doc.HasMember("entity_id") &&
-          existing_doc["entity_id"].GetUint64() == entity_id) {
-        rapidjson::Document new_doc;
-        new_doc.CopyFrom(entity, new_doc.GetAllocator());
-        entity_doc.set_document(std::move(new_doc));
-        found = true;
-        break;
-      }
-    }
+    rapidjson::Document entity_doc;
+    entity_doc.CopyFrom(entity, entity_doc.GetAllocator());
+    parsed.entities.emplace_back(entity["entity_id"].GetUint64(),
+                                 std::move(entity_doc));
+  }
+
+  return true;
+}
+
+void EntityList::swap_synced_entities() {
+  std::optional<ParsedSync> parsed;
+
+  {
+    std::lock_guard<std::mutex> lock(m_sync_mutex);
+    parsed.swap(m_parsed_sync);
+  }
+
+  if (!parsed) {
+    return;
+  }
+
+  if (parsed->generation == m_sync_generation && should_sync_runtime()) {
+    apply_sync(*parsed);
+  }
+
+  // the engine holds back further snapshots until this one is acked
+  if (parsed->sync_seq) {
+    EngineEventBus::get().publish<EngineEvent::SyncConsumed>(*parsed->sync_seq);
+  }
+}
+
+void EntityList::apply_sync(ParsedSync &parsed) {
+  for (auto &[entity_id, document] : parsed.entities) {
+    EntityDocument *entity_doc = find_entity(entity_id);
 
-    if (!found) {
+    if (entity_doc == nullptr) {
       log_error() << "Entity with ID " << entity_id
                   << " not found in entity list" << std::endl;
+      continue;
     }
+
+    entity_doc->set_document(std::move(document));
+  }
+
+  if (!m_is_synced_once) {
+    m_is_synced_once = true;
+    log_info() << "Initial sync with runtime" << std::endl;
+  }
+}
+
+EntityDocument *EntityList::find_entity(uint64_t entity_id) {
+  auto it = m_entity_index.find(entity_id);
+  if (it == m_entity_index.end()) {
+    return nullptr;
+  }
+  return &m_entities[it->second];
+}
+
+EntityDocument &EntityList::add_entity(EntityDocument entity) {
+  m_entities.push_back(std::move(entity));
+  index_entity(m_entities.size() - 1);
+  return m_entities.back();
+}
+
+void EntityList::remove_entity(uint64_t entity_id) {
+  auto it = m_entity_index.find(entity_id);
+  if (it == m_entity_index.end()) {
+    log_warning() << "Cannot remove unknown entity " << entity_id << std::endl;
+    return;
+  }
+
+  // the document stays in m_entities so that save can delete its file
+  m_entities[it->second].mark_as_dead();
+  m_entity_index.erase(it);
+}
+
+void EntityList::index_entity(size_t index) {
+  const EntityDocument &entity = m_entities[index];
+
+  // documents without an entity_id yet can't be found by a sync anyway
+  if (entity.get_entity_id() == 0) {
+    return;
+  }
+
+  auto [it, inserted] = m_entity_index.emplace(entity.get_entity_id(), index);
+
+  if (!inserted) {
+    log_warning() << "Duplicate entity_id " << entity.get_entity_id() << " in "
+                  << entity.get_name() << ", shadowing "
+                  << m_entities[it->second].get_name() << std::endl;
+    it->second = index;
   }
 }
 
@@ -219,6 +347,7 @@ void EntityList::clean_backup_entities() {
 
 void EntityList::load_entities(const std::filesystem::path &path) {
   m_entities.clear();
+  m_entity_index.clear();
 
   std::error_code ec;
   if (!std::filesystem::exists(path, ec)) {
@@ -252,9 +381,9 @@ void EntityList::load_entities(const std::filesystem::path &path) {
     std::filesystem::path file_path = entry.path();
     std::string file_name = file_path.stem().string();
 
-    auto &entity =
-        m_entities.emplace_back(EntityDocument(std::move(file_name)));
+    EntityDocument entity(std::move(file_name));
     entity.load_from_file(file_path);
+    add_entity(std::move(entity));
   }
 }
 
@@ -279,7 +408,7 @@ void EntityList::load_entity_from_file(const std::filesystem::path &path) {
     return;
   }
 
-  auto &entity = m_entities.emplace_back(EntityDocument(std::move(file_name)));
-
+  EntityDocument entity(std::move(file_name));
   entity.load_from_file(path);
+  add_entity(std::move(entity));
 }
@@ -24,9 +24,9 @@ void notify_engine_entity_variant_removed(uint64_t entity_id,
 void notify_entity_removed(uint64_t entity_id);
 }  // namespace
 
-Hierarchy::Hierarchy(std::vector<EntityDocument> &entities,
+Hierarchy::Hierarchy(EntityList &entity_list,
                      std::vector<VariantDocument> &variants)
-    : m_entities(entities), m_variants(variants) {
+    : m_entity_list(entity_list), m_variants(variants) {
   subscribe_events();
 }
 
@@ -35,7 +35,7 @@ void Hierarchy::update() {
   render_save_controls();
   ImGui::Separator();
 
-  for (auto &entity : m_entities) {
+  for (auto &entity : m_entity_list.get_entities()) {
     if (!entity.is_dead()) {
       render_entity(entity);
     }
@@ -68,7 +68,7 @@ void Hierarchy::render_save_controls() {
 }
 
 void Hierarchy::save_all_entities() {
-  for (auto &entity : m_entities) {
+  for (auto &entity : m_entity_list.get_entities()) {
     if (!entity.is_dead()) {
       entity.save_to_file();
     } else {
@@ -155,7 +155,7 @@ void Hierarchy::create_new_entity(const char *name) {
                                  }),
                   safe_name.end());
 
-  for (auto &entity : m_entities) {
+  for (auto &entity : m_entity_list.get_entities()) {
     if (!entity.is_dead() && entity.get_name() == safe_name) {
       log_error() << "Error Entity with name " << safe_name << " already exists"
                   << std::endl;
@@ -167,6 +167,9 @@ void Hierarchy::create_new_entity(const char *name) {
   std::mt19937_64 gen(rd());
   std::uniform_int_distribution<uint64_t> dis;
   uint64_t uuid = dis(gen);
+  while (uuid == 0 || m_entity_list.find_entity(uuid) != nullptr) {
+    uuid = dis(gen);
+  }
 
   rapidjson::Document new_doc;
   new_doc.SetObject();
@@ -177,7 +180,7 @@ void Hierarchy::create_new_entity(const char *name) {
   new_doc.AddMember("variants", variantsArray, allocator);
 
   EntityDocument entity(std::move(new_doc), safe_name);
-  m_entities.push_back(std::move(entity));
+  m_entity_list.add_entity(std::move(entity));
 }
 
 void Hierarchy::render_entity(EntityDocument &entity_document) {
@@ -186,10 +189,7 @@ void Hierarchy::render_entity(EntityDocument &entity_document) {
     return;
   }
 
-  uint64_t entity_id = 0;
-  if (document.HasMember("entity_id") && document["entity_id"].IsUint64()) {
-    entity_id = document["entity_id"].GetUint64();
-  }
+  uint64_t entity_id = entity_document.get_entity_id();
 
   const char *name = entity_document.get_name().c_str();
 
@@ -354,7 +354,7 @@ void Hierarchy::handle_entity_context_menu(EntityDocument &entity_document,
     }
 
     if (ImGui::MenuItem("Delete Entity")) {
-      entity_document.mark_as_dead();
+      m_entity_list.remove_entity(entity_id);
       notify_entity_removed(entity_id);
     }
 
@@ -968,8 +968,8 @@ void notify_engine_entity_property_changed(uint64_t entity_id,
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   change_notification.Accept(writer);
 
-  EngineEventBus::get().publish<const std::string &>(
-      EngineEvent::EntityModifiedEditor, buffer.GetString());
+  EngineEventBus::get().publish<EngineEvent::EntityModifiedEditor>(
+      buffer.GetString());
 }
 
 void notify_engine_entity_variant_added(uint64_t entity_id,
@@ -987,8 +987,8 @@ void notify_engine_entity_variant_added(uint64_t entity_id,
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   msg.Accept(writer);
 
-  EngineEventBus::get().publish<const std::string &>(
-      EngineEvent::EntityModifiedEditor, buffer.GetString());
+  EngineEventBus::get().publish<EngineEvent::EntityModifiedEditor>(
+      buffer.GetString());
 }
 
 void notify_engine_entity_variant_removed(uint64_t entity_id,
@@ -1006,8 +1006,8 @@ void notify_engine_entity_variant_removed(uint64_t entity_id,
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   msg.Accept(writer);
 
-  EngineEventBus::get().publish<const std::string &>(
-      EngineEvent::EntityModifiedEditor, buffer.GetString());
+  EngineEventBus::get().publish<EngineEvent::EntityModifiedEditor>(
+      buffer.GetString());
 }
 
 void notify_entity_removed(uint64_t entity_id) {
@@ -1021,7 +1021,7 @@ void notify_entity_removed(uint64_t entity_id) {
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   msg.Accept(writer);
 
-  EngineEventBus::get().publish<const std::string &>(
-      EngineEvent::EntityModifiedEditor, buffer.GetString());
+  EngineEventBus::get().publish<EngineEvent::EntityModifiedEditor>(
+      buffer.GetString());
 }
 }  // namespace
@@ -30,7 +30,7 @@ int main(int argc, char *argv[]) {
   EntityList entity_list;
   VariantList variant_list;
 
-  Hierarchy hierarchy(entity_list.get_entities(), variant_list.get_variants());
+  Hierarchy hierarchy(entity_list, variant_list.get_variants());
   TestViewer test_viewer;
 
   WindowManager window_manager;
@@ -56,6 +56,9 @@ int main(int argc, char *argv[]) {
       [&engine_controls] { engine_controls.render(); });
 
   while (!WindowShouldClose()) {
+    engine_communication.raise_events();
+    entity_list.swap_synced_entities();
+
     BeginDrawing();
     ClearBackground(BLACK);
 
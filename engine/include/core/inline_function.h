@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// std::function replacement that keeps the callable in an inline buffer.
+// Callables larger than Capacity fail to compile instead of allocating.
+template <typename Signature, size_t Capacity = 48>
+class InlineFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+  InlineFunction() = default;
+
+  template <typename F, typename Fn = std::decay_t<F>,
+            typename = std::enable_if_t<
+                !std::is_same_v<Fn, InlineFunction> &&
+                std::is_invocable_r_v<R, Fn&, Args...>>>
+  InlineFunction(F&& callable) {
+    static_assert(sizeof(Fn) <= Capacity,
+                  "callable does not fit in InlineFunction storage");
+    static_assert(alignof(Fn) <= alignof(std::max_align_t),
+                  "callable is over-aligned for InlineFunction storage");
+
+    new (&m_storage) Fn(std::forward<F>(callable));
+    m_invoke = &invoke<Fn>;
+    m_manage = &manage<Fn>;
+  }
+
+  InlineFunction(const InlineFunction& other) { copy_from(other); }
+
+  InlineFunction(InlineFunction&& other) noexcept { move_from(other); }
+
+  InlineFunction& operator=(const InlineFunction& other) {
+    if (this != &other) {
+      reset();
+      copy_from(other);
+    }
+    return *this;
+  }
+
+  InlineFunction& operator=(InlineFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      move_from(other);
+    }
+    return *this;
+  }
+
+  ~InlineFunction() { reset(); }
+
+  R operator()(Args... args) const {
+    return m_invoke(const_cast<void*>(static_cast<const void*>(&m_storage)),
+                    std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const { return m_invoke != nullptr; }
+
+  void reset() {
+    if (m_manage) {
+      m_manage(Operation::Destroy, &m_storage, nullptr);
+    }
+    m_invoke = nullptr;
+    m_manage = nullptr;
+  }
+
+private:
+  enum class Operation { Copy, Move, Destroy };
+
+  using Storage = std::aligned_storage_t<Capacity, alignof(std::max_align_t)>;
+  using Invoker = R (*)(void*, Args&&...);
+  using Manager = void (*)(Operation, void*, void*);
+
+  template <typename Fn>
+  static R invoke(void* storage, Args&&... args) {
+    return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+  }
+
+  template <typename Fn>
+  static void manage(Operation operation, void* dst, void* src) {
+    switch (operation) {
+      case Operation::Copy:
+        new (dst) Fn(*static_cast<const Fn*>(src));
+        break;
+      case Operation::Move:
+        new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+        static_cast<Fn*>(src)->~Fn();
+        break;
+      case Operation::Destroy:
+        static_cast<Fn*>(dst)->~Fn();
+        break;
+    }
+  }
+
+  void copy_from(const InlineFunction& other) {
+    if (other.m_manage) {
+      other.m_manage(Operation::Copy, &m_storage,
+                     const_cast<Storage*>(&other.m_storage));
+    }
+    m_invoke = other.m_invoke;
+    m_manage = other.m_manage;
+  }
+
+  void move_from(InlineFunction& other) {
+    if (other.m_manage) {
+      other.m_manage(Operation::Move, &m_storage, &other.m_storage);
+    }
+    m_invoke = other.m_invoke;
+    m_manage = other.m_manage;
+    other.m_invoke = nullptr;
+    other.m_manage = nullptr;
+  }
+
+  Storage m_storage;
+  Invoker m_invoke = nullptr;
+  Manager m_manage = nullptr;
+};
@@ -9,6 +9,8 @@
 #include "rttr/variant.h"
 #include "variant/variant_base.h"
 
+class Collider;
+
 namespace Query {
 
 inline entity_id create_entity() { return Zeytin::get().new_entity_id(); }
@@ -302,4 +304,34 @@ void remove_entity(const T& t) {
   Zeytin::get().remove_entity(t.entity_id);
 }
 
+// spatial queries, answered by the physics broad phase instead of a walk over
+// every collider. they see the colliders as of the start of the play update,
+// the editor keeps that current outside play mode. only colliders with a
+// category in layers are reported, disabled ones and the ones removed since
+// are skipped
+
+struct RaycastHit {
+  std::reference_wrapper<Collider> collider;
+  Vector2 point;
+  Vector2 normal;  // of the surface that was hit
+  float distance;
+};
+
+// first collider along the ray. one containing the origin is hit at distance
+// 0 with the normal facing back along the ray
+std::optional<RaycastHit> raycast(Vector2 origin, Vector2 direction,
+                                  float max_distance, int layers = -1);
+
+std::vector<std::reference_wrapper<Collider>> overlap_point(Vector2 point,
+                                                            int layers = -1);
+std::vector<std::reference_wrapper<Collider>> overlap_rect(Rectangle rect,
+                                                           int layers = -1);
+std::vector<std::reference_wrapper<Collider>> overlap_circle(
+    Vector2 center, float radius, int layers = -1);
+
+// up to count colliders closest to the point, closest first
+std::vector<std::reference_wrapper<Collider>> nearest(Vector2 point,
+                                                      size_t count,
+                                                      int layers = -1);
+
 }  // namespace Query
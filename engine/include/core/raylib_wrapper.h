@@ -2,6 +2,7 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "render/render_backend.h"
 
 inline void init_window(int width, int height, const char* title) {
   return InitWindow(width, height, title);
@@ -57,80 +58,115 @@ inline float get_mouse_wheel_move() { return GetMouseWheelMove(); }
 inline void set_mouse_position(int x, int y) { SetMousePosition(x, y); }
 inline void set_mouse_cursor(int cursor) { SetMouseCursor(cursor); }
 
-inline void begin_drawing() { BeginDrawing(); }
-inline void end_drawing() { EndDrawing(); }
-inline void begin_mode2d(Camera2D camera) { BeginMode2D(camera); }
-inline void end_mode2d() { EndMode2D(); }
+// drawing and gpu resources go through the render backend, raylib unless
+// a headless run replaced it
+inline void begin_drawing() { RenderBackend::get().begin_drawing(); }
+inline void end_drawing() { RenderBackend::get().end_drawing(); }
+inline void begin_mode2d(Camera2D camera) {
+  RenderBackend::get().begin_mode2d(camera);
+}
+inline void end_mode2d() { RenderBackend::get().end_mode2d(); }
 inline void begin_texture_mode(RenderTexture2D target) {
-  BeginTextureMode(target);
+  RenderBackend::get().begin_texture_mode(target);
 }
-inline void end_texture_mode() { EndTextureMode(); }
-inline void clear_background(Color color) { ClearBackground(color); }
+inline void end_texture_mode() { RenderBackend::get().end_texture_mode(); }
+inline void clear_background(Color color) {
+  RenderBackend::get().clear_background(color);
+}
+inline void begin_scissor_mode(int posX, int posY, int width, int height) {
+  RenderBackend::get().begin_scissor_mode(posX, posY, width, height);
+}
+inline void end_scissor_mode() { RenderBackend::get().end_scissor_mode(); }
 inline void draw_line(int startX, int startY, int endX, int endY, Color color) {
-  DrawLine(startX, startY, endX, endY, color);
+  RenderBackend::get().draw_line(Vector2{(float)startX, (float)startY},
+                                 Vector2{(float)endX, (float)endY}, color);
 }
 inline void draw_line_v(Vector2 startPos, Vector2 endPos, Color color) {
-  DrawLineV(startPos, endPos, color);
+  RenderBackend::get().draw_line(startPos, endPos, color);
 }
 inline void draw_circle(int centerX, int centerY, float radius, Color color) {
-  DrawCircle(centerX, centerY, radius, color);
+  RenderBackend::get().draw_circle(Vector2{(float)centerX, (float)centerY},
+                                   radius, color);
 }
 inline void draw_circle_v(Vector2 center, float radius, Color color) {
-  DrawCircleV(center, radius, color);
+  RenderBackend::get().draw_circle(center, radius, color);
 }
 inline void draw_circle_lines(int centerX, int centerY, float radius,
                               Color color) {
-  DrawCircleLines(centerX, centerY, radius, color);
+  RenderBackend::get().draw_circle_lines(
+      Vector2{(float)centerX, (float)centerY}, radius, color);
 }
 inline void draw_rectangle(int posX, int posY, int width, int height,
                            Color color) {
-  DrawRectangle(posX, posY, width, height, color);
+  RenderBackend::get().draw_rectangle(
+      Rectangle{(float)posX, (float)posY, (float)width, (float)height}, color);
 }
 inline void draw_rectangle_v(Vector2 position, Vector2 size, Color color) {
-  DrawRectangleV(position, size, color);
+  RenderBackend::get().draw_rectangle(
+      Rectangle{position.x, position.y, size.x, size.y}, color);
 }
 inline void draw_rectangle_rec(Rectangle rec, Color color) {
-  DrawRectangleRec(rec, color);
+  RenderBackend::get().draw_rectangle(rec, color);
 }
 inline void draw_rectangle_lines(int posX, int posY, int width, int height,
                                  Color color) {
-  DrawRectangleLines(posX, posY, width, height, color);
+  RenderBackend::get().draw_rectangle_lines(
+      Rectangle{(float)posX, (float)posY, (float)width, (float)height}, 1.0f,
+      color);
 }
 inline void draw_rectangle_lines_ex(Rectangle rec, float lineThick,
                                     Color color) {
-  DrawRectangleLinesEx(rec, lineThick, color);
+  RenderBackend::get().draw_rectangle_lines(rec, lineThick, color);
 }
 inline void draw_text(const char* text, int posX, int posY, int fontSize,
                       Color color) {
-  DrawText(text, posX, posY, fontSize, color);
+  RenderBackend::get().draw_text(text, Vector2{(float)posX, (float)posY},
+                                 fontSize, color);
 }
 inline void draw_texture(Texture2D texture, int posX, int posY, Color tint) {
-  DrawTexture(texture, posX, posY, tint);
+  RenderBackend::get().draw_texture(
+      texture, Rectangle{0, 0, (float)texture.width, (float)texture.height},
+      Rectangle{(float)posX, (float)posY, (float)texture.width,
+                (float)texture.height},
+      Vector2{0, 0}, 0.0f, tint);
 }
 inline void draw_texture_ex(Texture2D texture, Vector2 position, float rotation,
                             float scale, Color tint) {
-  DrawTextureEx(texture, position, rotation, scale, tint);
+  RenderBackend::get().draw_texture(
+      texture, Rectangle{0, 0, (float)texture.width, (float)texture.height},
+      Rectangle{position.x, position.y, texture.width * scale,
+                texture.height * scale},
+      Vector2{0, 0}, rotation, tint);
 }
 inline void draw_texture_pro(Texture2D texture, Rectangle source,
                              Rectangle dest, Vector2 origin, float rotation,
                              Color tint) {
-  DrawTexturePro(texture, source, dest, origin, rotation, tint);
+  RenderBackend::get().draw_texture(texture, source, dest, origin, rotation,
+                                    tint);
 }
 
 inline Texture2D load_texture(const char* fileName) {
-  return LoadTexture(fileName);
+  return RenderBackend::get().load_texture(fileName);
+}
+inline void unload_texture(Texture2D texture) {
+  RenderBackend::get().unload_texture(texture);
+}
+inline void update_texture(Texture2D texture, const void* pixels) {
+  RenderBackend::get().update_texture(texture, pixels);
 }
-inline void unload_texture(Texture2D texture) { UnloadTexture(texture); }
 inline Image load_image(const char* fileName) { return LoadImage(fileName); }
 inline void unload_image(Image image) { UnloadImage(image); }
 inline Texture2D load_texture_from_image(Image image) {
-  return LoadTextureFromImage(image);
+  return RenderBackend::get().load_texture_from_image(image);
 }
 inline RenderTexture2D load_render_texture(int width, int height) {
-  return LoadRenderTexture(width, height);
+  return RenderBackend::get().load_render_texture(width, height);
 }
 inline void unload_render_texture(RenderTexture2D target) {
-  UnloadRenderTexture(target);
+  RenderBackend::get().unload_render_texture(target);
+}
+inline Font get_font_default() {
+  return RenderBackend::get().get_font_default();
 }
 
 inline bool check_collision_recs(Rectangle rec1, Rectangle rec2) {
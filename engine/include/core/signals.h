@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "core/inline_function.h"
+
+// Gameplay signals. Slots live inline in a flat array, so emitting is a loop
+// of direct calls, and every connect hands back a Connection token. Not
+// thread safe, signals are connected and emitted from the game loop.
+
+class SignalStateBase {
+public:
+  virtual ~SignalStateBase() = default;
+  virtual void disconnect(uint64_t id) = 0;
+};
+
+class Connection {
+public:
+  Connection() = default;
+  Connection(std::weak_ptr<SignalStateBase> state, uint64_t id)
+      : m_state(std::move(state)), m_id(id) {}
+
+  // safe to call after the signal itself is gone
+  void disconnect() {
+    if (auto state = m_state.lock()) {
+      state->disconnect(m_id);
+    }
+    m_state.reset();
+  }
+
+  bool is_connected() const { return !m_state.expired(); }
+
+private:
+  std::weak_ptr<SignalStateBase> m_state;
+  uint64_t m_id = 0;
+};
+
+// Disconnects everything it holds when destroyed. Meant as a variant member,
+// copies start out empty since the slots point at the original instance, so
+// a variant copied around by the storage never keeps a dangling slot alive.
+class ScopedConnections {
+public:
+  ScopedConnections() = default;
+  ScopedConnections(const ScopedConnections&) {}
+  ScopedConnections& operator=(const ScopedConnections&) { return *this; }
+  ~ScopedConnections() { disconnect_all(); }
+
+  void add(Connection connection) {
+    m_connections.push_back(std::move(connection));
+  }
+
+  void disconnect_all() {
+    for (auto& connection : m_connections) {
+      connection.disconnect();
+    }
+    m_connections.clear();
+  }
+
+private:
+  std::vector<Connection> m_connections;
+};
+
+template <typename... Args>
+class Signal {
+public:
+  using Slot = InlineFunction<void(Args...), 32>;
+
+  Signal() : m_state(std::make_shared<State>()) {}
+
+  // a copy is a new signal, connections stay with the original
+  Signal(const Signal&) : Signal() {}
+  Signal& operator=(const Signal&) { return *this; }
+
+  Connection connect(Slot slot) {
+    State& state = *m_state;
+    uint64_t id = ++state.next_id;
+
+    // connecting from a slot must not move the slot that is running
+    auto& slots = state.emitting > 0 ? state.pending : state.slots;
+    slots.push_back({id, std::move(slot)});
+
+    return Connection(m_state, id);
+  }
+
+  // binds a member function at compile time, the call inlines into the slot
+  template <auto Method, typename T>
+  Connection connect(T* object) {
+    return connect(Slot([object](Args... args) {
+      (object->*Method)(std::forward<Args>(args)...);
+    }));
+  }
+
+  void emit(Args... args) const {
+    State& state = *m_state;
+    state.emitting++;
+
+    for (size_t i = 0; i < state.slots.size(); i++) {
+      if (state.slots[i].id != 0) {
+        state.slots[i].callback(args...);
+      }
+    }
+
+    finish_emit(state);
+  }
+
+  // slot-major emission over a batch, each slot runs over every item before
+  // the next slot starts. items may be values or pointers to the argument
+  template <typename Batch>
+  void emit_batch(const Batch& batch) const {
+    State& state = *m_state;
+    state.emitting++;
+
+    for (size_t i = 0; i < state.slots.size(); i++) {
+      for (const auto& item : batch) {
+        if (state.slots[i].id == 0) break;
+
+        if constexpr (std::is_pointer_v<std::decay_t<decltype(item)>>) {
+          state.slots[i].callback(*item);
+        } else {
+          state.slots[i].callback(item);
+        }
+      }
+    }
+
+    finish_emit(state);
+  }
+
+  size_t size() const { return m_state->slots.size(); }
+  bool empty() const { return m_state->slots.empty(); }
+
+private:
+  struct Entry {
+    uint64_t id;  // 0 once disconnected, removed after the emit finishes
+    Slot callback;
+  };
+
+  struct State : SignalStateBase {
+    std::vector<Entry> slots;
+    std::vector<Entry> pending;
+    uint64_t next_id = 0;
+    int emitting = 0;
+    bool dirty = false;
+
+    void disconnect(uint64_t id) override {
+      for (auto* list : {&slots, &pending}) {
+        for (auto& entry : *list) {
+          if (entry.id == id) {
+            entry.id = 0;
+            dirty = true;
+          }
+        }
+      }
+
+      if (emitting == 0) compact();
+    }
+
+    void compact() {
+      if (!dirty) return;
+
+      for (auto* list : {&slots, &pending}) {
+        list->erase(std::remove_if(list->begin(), list->end(),
+                                   [](const Entry& entry) {
+                                     return entry.id == 0;
+                                   }),
+                    list->end());
+      }
+      dirty = false;
+    }
+  };
+
+  static void finish_emit(State& state) {
+    if (--state.emitting > 0) return;
+
+    for (auto& entry : state.pending) {
+      state.slots.push_back(std::move(entry));
+    }
+    state.pending.clear();
+    state.compact();
+  }
+
+  std::shared_ptr<State> m_state;
+};
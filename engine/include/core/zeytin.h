@@ -38,7 +38,7 @@ public:
 
   void load_scene(const std::filesystem::path&);
 
-  std::string serialize_scene();
+  std::string serialize_scene(std::optional<uint64_t> sync_seq = std::nullopt);
   bool deserialize_scene(const std::string& scene);
 
   void post_init_variants();
@@ -72,6 +72,7 @@ public:
   void handle_entity_variant_added(const rapidjson::Document& msg);
   void handle_entity_variant_removed(const rapidjson::Document& msg);
   void handle_entity_removed(const rapidjson::Document& msg);
+  void handle_sync_acknowledged(uint64_t sync_seq);
 
   inline bool is_play_mode() const { return m_is_play_mode; }
   inline bool is_paused_play_mode() const { return m_is_pause_play_mode; }
@@ -103,6 +104,18 @@ private:
   Camera2D m_camera;
 
 #ifdef EDITOR_MODE
+  void publish_sync(std::string scene);
+
   std::unique_ptr<EditorCommunication> m_editor_communication;
+
+  // editor sync backpressure: a new snapshot is only sent once the editor has
+  // acknowledged the previous one (or it timed out), at an interval adapted to
+  // the payload size and the measured acknowledgement lag
+  uint64_t m_sync_seq = 0;
+  uint64_t m_acked_sync_seq = 0;
+  double m_last_sync_time = 0.0;
+  float m_sync_interval = 0.1f;
+  float m_sync_lag = 0.0f;
+  size_t m_last_sync_size = 0;
 #endif
 };
@@ -3,10 +3,13 @@
 #ifdef EDITOR_MODE
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <vector>
+#include "editor/event_channel.h"
 #include "zmq/zmq.hpp"
 
 class EditorCommunication {
@@ -23,14 +26,18 @@ public:
 
 private:
   void receive_messages();
-  void start_connection_attempts();
+  // sends engine_started about once a second until the editor confirms it,
+  // on the thread calling raise_events since the sockets aren't thread safe
+  void attempt_connection();
   void send_started_message();
   void send_shutdown_message();
 
-  bool m_running;
+  std::atomic<bool> m_running;
   bool m_initialized;
 
   std::atomic<bool> m_connection_confirmed{false};
+  int m_connection_attempts = 0;
+  std::chrono::steady_clock::time_point m_last_connection_attempt;
 
   zmq::context_t m_context;
   zmq::socket_t m_publisher;
@@ -38,5 +45,7 @@ private:
   std::thread m_receive_thread;
   std::mutex m_queue_mutex;
   std::queue<std::string> m_message_queue;
+
+  std::vector<EventSubscription> m_subscriptions;
 };
 #endif
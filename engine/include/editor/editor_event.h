@@ -1,10 +1,11 @@
-#include <algorithm>
-#include <any>
-#include <functional>
-#include <map>
-#include <mutex>
-#include <shared_mutex>
-#include <vector>
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "editor/event_channel.h"
+#include "editor/event_queue.h"
+#include "rapidjson/fwd.h"
 
 #ifdef EDITOR_MODE
 
@@ -20,11 +21,46 @@ enum class EditorEvent {
   UnPausePlayMode,
   ExitPlayMode,
   SyncEditor,
+  SyncAcknowledged,
   Die,
   LogToEditor,
   WindowStateChanged,
 };
 
+// payload carried by each event, publishers and subscribers are checked
+// against it at compile time
+template <EditorEvent E>
+struct EditorEventPayload;
+
+#define EDITOR_EVENT_PAYLOAD(event, payload) \
+  template <>                                \
+  struct EditorEventPayload<EditorEvent::event> { using type = payload; }
+
+EDITOR_EVENT_PAYLOAD(EngineStartConfirmed, bool);
+EDITOR_EVENT_PAYLOAD(Scene, std::string);
+EDITOR_EVENT_PAYLOAD(EntityRemoved, rapidjson::Document);
+EDITOR_EVENT_PAYLOAD(EntityPropertyChanged, rapidjson::Document);
+EDITOR_EVENT_PAYLOAD(EntityVariantAdded, rapidjson::Document);
+EDITOR_EVENT_PAYLOAD(EntityVariantRemoved, rapidjson::Document);
+EDITOR_EVENT_PAYLOAD(EnterPlayMode, bool);
+EDITOR_EVENT_PAYLOAD(PausePlayMode, bool);
+EDITOR_EVENT_PAYLOAD(UnPausePlayMode, bool);
+EDITOR_EVENT_PAYLOAD(ExitPlayMode, bool);
+EDITOR_EVENT_PAYLOAD(SyncEditor, std::string);
+EDITOR_EVENT_PAYLOAD(SyncAcknowledged, uint64_t);
+EDITOR_EVENT_PAYLOAD(Die, bool);
+EDITOR_EVENT_PAYLOAD(LogToEditor, std::string);
+EDITOR_EVENT_PAYLOAD(WindowStateChanged, rapidjson::Document);
+
+#undef EDITOR_EVENT_PAYLOAD
+
+template <EditorEvent E>
+using EditorEventPayloadT = typename EditorEventPayload<E>::type;
+
+template <EditorEvent E>
+using EditorEventCallback =
+    typename EventChannel<EditorEventPayloadT<E>>::Callback;
+
 class EditorEventBus {
 public:
   static EditorEventBus& get() {
@@ -32,56 +68,43 @@ public:
     return instance;
   }
 
-  template <typename T>
-  void publish(EditorEvent event, const T& data) {
-    std::shared_lock<std::shared_mutex> lock(m_mutex);
-
-    auto it = m_subscribers.find(event);
-    if (it != m_subscribers.end()) {
-      auto callbacks = it->second;
-      lock.unlock();
-
-      for (auto& callback : callbacks) {
-        if (auto func =
-                std::any_cast<std::function<void(const T&)>>(&callback)) {
-          (*func)(data);
-        }
-      }
-    }
+  template <EditorEvent E>
+  void publish(const EditorEventPayloadT<E>& data) {
+    channel<E>().publish(data);
   }
 
-  template <typename T>
-  void subscribe(EditorEvent event, std::function<void(const T&)> callback) {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
-    m_subscribers[event].push_back(std::any(callback));
+  // thread safe, handlers run on the thread that calls flush. the payload is
+  // moved into the queue
+  template <EditorEvent E>
+  void post(EditorEventPayloadT<E> data) {
+    static_assert(std::is_move_constructible_v<EditorEventPayloadT<E>>,
+                  "posted event payloads have to be movable, the queue takes "
+                  "them by move");
+    m_deferred.push([this, data = std::move(data)]() {
+      channel<E>().publish(data);
+    });
   }
 
-  template <typename T>
-  void unsubscribe(EditorEvent event,
-                   const std::function<void(const T&)>* callback_ptr) {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
-
-    auto it = m_subscribers.find(event);
-    if (it != m_subscribers.end()) {
-      auto& callbacks = it->second;
-      callbacks.erase(
-          std::remove_if(
-              callbacks.begin(), callbacks.end(),
-              [callback_ptr](const std::any& item) {
-                auto func = std::any_cast<std::function<void(const T&)>>(&item);
-                return func &&
-                       func->target_type() == callback_ptr->target_type();
-              }),
-          callbacks.end());
-    }
+  // called once per frame on the main thread
+  size_t flush() { return m_deferred.flush(); }
+
+  template <EditorEvent E>
+  EventSubscription subscribe(EditorEventCallback<E> callback) {
+    return channel<E>().subscribe(std::move(callback));
   }
 
 private:
   EditorEventBus() = default;
   ~EditorEventBus() = default;
 
-  std::map<EditorEvent, std::vector<std::any>> m_subscribers;
-  std::shared_mutex m_mutex;
+  // one channel per event, resolved at compile time
+  template <EditorEvent E>
+  EventChannel<EditorEventPayloadT<E>>& channel() {
+    static EventChannel<EditorEventPayloadT<E>> instance;
+    return instance;
+  }
+
+  DeferredEventQueue m_deferred;
 };
 
 #endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Multi-producer, single-consumer queue of deferred event dispatches.
+// Posting is a single atomic exchange so any thread can post without taking
+// a lock, flush runs the handlers on whichever thread calls it. Intrusive
+// list with a stub node, after Dmitry Vyukov's MPSC queue. The task lives in
+// its node, so it may be move-only and of any size.
+class DeferredEventQueue {
+public:
+  DeferredEventQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+  ~DeferredEventQueue() {
+    while (Node* node = pop()) {
+      delete node;
+    }
+  }
+
+  DeferredEventQueue(const DeferredEventQueue&) = delete;
+  DeferredEventQueue& operator=(const DeferredEventQueue&) = delete;
+
+  template <typename F>
+  void push(F&& task) {
+    using Fn = std::decay_t<F>;
+    static_assert(std::is_invocable_v<Fn&>, "tasks take no arguments");
+    static_assert(std::is_constructible_v<Fn, F&&>,
+                  "tasks are moved or copied into the queue");
+
+    Node* node = new TaskNode<Fn>(std::forward<F>(task));
+    Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    m_pushed.fetch_add(1, std::memory_order_release);
+  }
+
+  // runs everything posted before the call, events posted by the handlers
+  // themselves wait for the next flush so a handler that posts can't spin
+  // forever. the batch is bounded by a count, the head may be the stub with
+  // events still queued in front of it. single consumer only.
+  size_t flush() {
+    size_t pending = m_pushed.load(std::memory_order_acquire) - m_popped;
+
+    size_t count = 0;
+    while (count < pending) {
+      Node* node = pop();
+      if (!node) break;
+
+      node->run();
+      delete node;
+      count++;
+    }
+    m_popped += count;
+    return count;
+  }
+
+private:
+  struct Node {
+    virtual ~Node() = default;
+    virtual void run() {}  // the stub has nothing to run
+
+    std::atomic<Node*> next{nullptr};
+  };
+
+  template <typename Fn>
+  struct TaskNode : Node {
+    template <typename F>
+    explicit TaskNode(F&& task) : task(std::forward<F>(task)) {}
+    void run() override { task(); }
+
+    Fn task;
+  };
+
+  // returns nullptr when empty or when a producer is halfway through a push,
+  // that event is picked up by the next flush
+  Node* pop() {
+    Node* tail = m_tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+      if (!next) return nullptr;
+      m_tail = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+      m_tail = next;
+      return tail;
+    }
+
+    if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+
+    push_stub();
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+      m_tail = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  void push_stub() {
+    m_stub.next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = m_head.exchange(&m_stub, std::memory_order_acq_rel);
+    prev->next.store(&m_stub, std::memory_order_release);
+  }
+
+  std::atomic<Node*> m_head;
+  Node* m_tail;
+  Node m_stub;
+  std::atomic<size_t> m_pushed{0};
+  size_t m_popped = 0;  // consumer only
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/signals.h"
 #include "game/collider.h"
 #include "game/game.h"
 #include "game/position.h"
@@ -26,4 +27,5 @@ private:
   void keep_in_bounds();
 
   bool m_launched = false;
+  ScopedConnections m_connections;
 };
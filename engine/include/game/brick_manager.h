@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/signals.h"
 #include "game/brick.h"
 #include "game/collider.h"
 #include "game/position.h"
@@ -35,4 +36,6 @@ public:
 private:
   void create_brick(float x, float y, int row, int col);
   Color get_brick_color(int row) const;
+
+  ScopedConnections m_connections;
 };
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "core/signals.h"
 #include "game/position.h"
+#include "physics/aabb.h"
+#include "physics/collision_shape.h"
+#include "physics/physics_proxy.h"
 #include "variant/variant_base.h"
 
 class Collider : public VariantBase {
@@ -21,25 +25,46 @@ public:
 
   bool m_static = false;
   PROPERTY()
+
+  // one bit per collision layer. two colliders only meet when each one's
+  // category is in the other's mask, and the layers are allowed to meet in
+  // the physics_layer_<n>_mask config keys
+  int m_category = 1;
+  PROPERTY()
+  int m_mask = -1;
+  PROPERTY()
   bool m_draw_debug = false;
   PROPERTY()
 
   void on_update() override;
-  void on_play_update() override;
   bool intersects(const Collider& other) const;
 
   Rectangle get_rectangle() const;
   Vector2 get_circle_center() const;
   inline float get_radius() const { return m_radius; }
+  CollisionShape get_shape() const;
+  inline Aabb get_bounds() const { return get_shape().bounds(); }
 
-  std::function<void(Collider& other)> m_callback;
+  // contacts found by the physics job, sent at the start of the next play
+  // update. enter fires in the frame the pair starts touching, stay once per
+  // frame while it keeps touching and exit once they separate
+  Signal<Collider&> m_on_collision_enter;
+  Signal<Collider&> m_on_collision_stay;
+  Signal<Collider&> m_on_collision_exit;
+
+  inline bool has_contact_listeners() const {
+    return !m_on_collision_enter.empty() || !m_on_collision_stay.empty() ||
+           !m_on_collision_exit.empty();
+  }
 
   inline void set_enable(bool value) { m_enable = value; }
   inline bool is_enable() { return m_enable; }
 
+  // managed by the physics world
+  PhysicsProxy m_proxy;
+
 private:
   void debug_draw();
-  void check_collisions();
 
   bool m_enable = true;
 };
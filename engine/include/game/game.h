@@ -1,12 +1,9 @@
 #pragma once
 
-#include <functional>
-#include <vector>
+#include "core/signals.h"
 #include "game/brick.h"
 #include "variant/variant_base.h"
 
-using callback = std::function<void()>;
-
 enum class GameState {
   None = 0,
   Idle,
@@ -28,14 +25,16 @@ public:
   void end_game();
   void on_break_destroyed(const Brick& brick);
 
-  void register_on_game_start(callback cb);
-  void register_on_game_end(callback cb);
-  void register_on_brick_destoryed(std::function<void(const Brick& brick)> cb);
+  // keep the returned connection in a ScopedConnections member so the slot
+  // goes away with the variant that registered it
+  Connection register_on_game_start(Signal<>::Slot cb);
+  Connection register_on_game_end(Signal<>::Slot cb);
+  Connection register_on_brick_destoryed(Signal<const Brick&>::Slot cb);
 
 private:
   GameState m_game_state = GameState::Idle;
 
-  std::vector<callback> m_game_start_callbacks;
-  std::vector<callback> m_game_end_callbacks;
-  std::vector<std::function<void(const Brick& brick)>> m_on_brick_destroyed;
+  Signal<> m_on_game_start;
+  Signal<> m_on_game_end;
+  Signal<const Brick&> m_on_brick_destroyed;
 };
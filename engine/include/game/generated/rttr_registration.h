@@ -82,6 +82,8 @@ RTTR_REGISTRATION
         .property("m_height", &Collider::m_height)
         .property("m_radius", &Collider::m_radius)
         .property("m_static", &Collider::m_static)
+        .property("m_category", &Collider::m_category)
+        .property("m_mask", &Collider::m_mask)
         .property("m_draw_debug", &Collider::m_draw_debug);
 
     rttr::registration::class_<Scale>("Scale")
@@ -152,6 +154,8 @@ RTTR_REGISTRATION
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
         .property("path_to_sprite", &Sprite::path_to_sprite)(rttr::metadata("SET_CALLBACK", "handle_new_path"))
+        .property("layer", &Sprite::layer)
+        .property("is_static", &Sprite::is_static)
 
         .method("handle_new_path", &Sprite::handle_new_path);
 
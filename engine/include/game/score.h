@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/signals.h"
 #include "game/brick.h"
 #include "variant/variant_base.h"
 
@@ -27,4 +28,7 @@ public:
   }
 
   void on_update() override;
+
+private:
+  ScopedConnections m_connections;
 };
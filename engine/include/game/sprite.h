@@ -3,6 +3,7 @@
 #include "game/position.h"
 #include "game/scale.h"
 #include "raylib.h"
+#include "render/sprite_batch.h"
 #include "variant/variant_base.h"
 
 class Sprite : public VariantBase {
@@ -11,6 +12,10 @@ class Sprite : public VariantBase {
 public:
   std::string path_to_sprite;
   PROPERTY() SET_CALLBACK(handle_new_path);
+  int layer = 0;
+  PROPERTY()
+  bool is_static = false;
+  PROPERTY()  // backgrounds, drawn into the static layer
 
   void on_init() override;
   void on_update() override;
@@ -18,6 +23,6 @@ public:
 private:
   void basic_move();
 
-  Texture texture;
+  SpriteFrame m_frame;
   bool m_texture_loaded = false;
 };
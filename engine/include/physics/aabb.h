@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+
+// axis aligned bounding box in world space, min is the top left corner
+struct Aabb {
+  float min_x = 0.0f;
+  float min_y = 0.0f;
+  float max_x = 0.0f;
+  float max_y = 0.0f;
+
+  inline float width() const { return max_x - min_x; }
+  inline float height() const { return max_y - min_y; }
+
+  // the surface area heuristic of the tree builders in 2d
+  inline float perimeter() const { return 2.0f * (width() + height()); }
+
+  inline bool overlaps(const Aabb& other) const {
+    return min_x <= other.max_x && max_x >= other.min_x &&
+           min_y <= other.max_y && max_y >= other.min_y;
+  }
+
+  inline bool contains(const Aabb& other) const {
+    return min_x <= other.min_x && min_y <= other.min_y &&
+           max_x >= other.max_x && max_y >= other.max_y;
+  }
+
+  inline Aabb merged(const Aabb& other) const {
+    return Aabb{std::min(min_x, other.min_x), std::min(min_y, other.min_y),
+                std::max(max_x, other.max_x), std::max(max_y, other.max_y)};
+  }
+
+  // squared distance from a point, 0 inside
+  inline float distance_squared(float x, float y) const {
+    float dx = std::max({min_x - x, 0.0f, x - max_x});
+    float dy = std::max({min_y - y, 0.0f, y - max_y});
+    return dx * dx + dy * dy;
+  }
+
+  // whether the segment from (x, y) to (x + dx, y + dy) touches the box
+  // before the given fraction of its length
+  inline bool intersects_segment(float x, float y, float dx, float dy,
+                                 float max_fraction) const {
+    float t_enter = 0.0f;
+    float t_exit = max_fraction;
+
+    auto clip = [&](float p, float d, float low, float high) {
+      if (d == 0.0f) return p >= low && p <= high;
+
+      float t0 = (low - p) / d;
+      float t1 = (high - p) / d;
+      if (t0 > t1) std::swap(t0, t1);
+
+      t_enter = std::max(t_enter, t0);
+      t_exit = std::min(t_exit, t1);
+      return t_enter <= t_exit;
+    };
+
+    return clip(x, dx, min_x, max_x) && clip(y, dy, min_y, max_y);
+  }
+
+  inline Aabb expanded(float margin) const {
+    return Aabb{min_x - margin, min_y - margin, max_x + margin,
+                max_y + margin};
+  }
+};
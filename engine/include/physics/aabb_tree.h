@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "physics/aabb.h"
+
+// Dynamic bounding volume hierarchy, after Box2D's b2DynamicTree. Leaves store
+// fattened bounds so a proxy that moves a little stays where it is, and the
+// tree is kept balanced with rotations on every insert and removal. Proxy ids
+// are node indices and stay valid until destroy_proxy, rebuild included.
+class AabbTree {
+public:
+  static constexpr int32_t k_null = -1;
+
+  int32_t create_proxy(const Aabb& bounds, uint32_t user_data,
+                       float margin = 0.0f);
+  void destroy_proxy(int32_t proxy);
+
+  // reinserts the proxy only when the bounds left its fat bounds, returns
+  // whether it did
+  bool move_proxy(int32_t proxy, const Aabb& bounds, float margin);
+
+  // rebuilds the internal nodes top down from the current leaves, for trees
+  // that changed in bulk
+  void rebuild();
+  void clear();
+
+  inline const Aabb& get_fat_bounds(int32_t proxy) const {
+    return m_nodes[proxy].bounds;
+  }
+  inline uint32_t get_user_data(int32_t proxy) const {
+    return m_nodes[proxy].user_data;
+  }
+  inline size_t get_proxy_count() const { return m_proxy_count; }
+  inline int32_t get_height() const {
+    return m_root == k_null ? 0 : m_nodes[m_root].height;
+  }
+
+  // calls fn(user_data) for every leaf whose fat bounds overlap the box
+  template <typename F>
+  void query(const Aabb& box, F&& fn) const {
+    if (m_root == k_null) return;
+
+    TraversalStack stack;
+    stack.push(m_root);
+
+    while (!stack.empty()) {
+      const Node& node = m_nodes[stack.pop()];
+      if (!node.bounds.overlaps(box)) continue;
+
+      if (node.is_leaf()) {
+        fn(node.user_data);
+      } else {
+        stack.push(node.child1);
+        stack.push(node.child2);
+      }
+    }
+  }
+
+  // calls fn(user_data, max_fraction) for every leaf whose fat bounds the
+  // segment from (x, y) to (x + dx, y + dy) passes through before
+  // max_fraction. fn returns the new max fraction, a hit clips the rest of
+  // the search and 0 ends it
+  template <typename F>
+  void raycast(float x, float y, float dx, float dy, float max_fraction,
+               F&& fn) const {
+    if (m_root == k_null) return;
+
+    TraversalStack stack;
+    stack.push(m_root);
+
+    while (!stack.empty()) {
+      const Node& node = m_nodes[stack.pop()];
+      if (!node.bounds.intersects_segment(x, y, dx, dy, max_fraction)) {
+        continue;
+      }
+
+      if (node.is_leaf()) {
+        max_fraction = fn(node.user_data, max_fraction);
+        if (max_fraction <= 0.0f) return;
+      } else {
+        stack.push(node.child1);
+        stack.push(node.child2);
+      }
+    }
+  }
+
+  // calls fn(user_data, bounds_distance_sq) for the leaves in order of the
+  // squared distance of their fat bounds from the point, until fn returns
+  // false
+  template <typename F>
+  void visit_nearest(float x, float y, F&& fn) const {
+    if (m_root == k_null) return;
+
+    using Entry = std::pair<float, int32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    open.emplace(m_nodes[m_root].bounds.distance_squared(x, y), m_root);
+
+    while (!open.empty()) {
+      auto [distance_sq, id] = open.top();
+      open.pop();
+
+      const Node& node = m_nodes[id];
+      if (node.is_leaf()) {
+        if (!fn(node.user_data, distance_sq)) return;
+        continue;
+      }
+
+      open.emplace(m_nodes[node.child1].bounds.distance_squared(x, y),
+                   node.child1);
+      open.emplace(m_nodes[node.child2].bounds.distance_squared(x, y),
+                   node.child2);
+    }
+  }
+
+private:
+  struct Node {
+    Aabb bounds;
+    uint32_t user_data = 0;
+    int32_t parent = k_null;  // next free node while on the free list
+    int32_t child1 = k_null;
+    int32_t child2 = k_null;
+    int32_t height = -1;  // 0 for leaves, -1 for free nodes
+
+    inline bool is_leaf() const { return child1 == k_null; }
+  };
+
+  // fixed stack for the common case, spills to the heap for deep trees
+  class TraversalStack {
+  public:
+    inline void push(int32_t node) {
+      if (m_size < k_inline_size) {
+        m_inline[m_size] = node;
+      } else {
+        m_spill.push_back(node);
+      }
+      m_size++;
+    }
+
+    inline int32_t pop() {
+      m_size--;
+      if (m_size < k_inline_size) return m_inline[m_size];
+      int32_t node = m_spill.back();
+      m_spill.pop_back();
+      return node;
+    }
+
+    inline bool empty() const { return m_size == 0; }
+
+  private:
+    static constexpr size_t k_inline_size = 128;
+    int32_t m_inline[k_inline_size];
+    std::vector<int32_t> m_spill;
+    size_t m_size = 0;
+  };
+
+  int32_t allocate_node();
+  void free_node(int32_t node);
+
+  void insert_leaf(int32_t leaf);
+  void remove_leaf(int32_t leaf);
+  int32_t balance(int32_t node);
+  void refit_upwards(int32_t node);
+
+  int32_t build_top_down(int32_t* leaves, size_t count);
+
+  std::vector<Node> m_nodes;
+  std::vector<int32_t> m_leaves;  // scratch for rebuild
+  int32_t m_root = k_null;
+  int32_t m_free_list = k_null;
+  size_t m_proxy_count = 0;
+};
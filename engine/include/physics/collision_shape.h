@@ -0,0 +1,24 @@
+#pragma once
+
+#include "physics/aabb.h"
+
+// Collider geometry resolved against its Position, what the narrow phase
+// tests. Rectangles are centered on the position like Collider draws them.
+struct CollisionShape {
+  enum Type : int { None = 0, Rectangle = 1, Circle = 2 };
+
+  int type = None;
+  float x = 0.0f;
+  float y = 0.0f;
+  float half_width = 0.0f;
+  float half_height = 0.0f;
+  float radius = 0.0f;
+
+  inline Aabb bounds() const {
+    if (type == Circle) {
+      return Aabb{x - radius, y - radius, x + radius, y + radius};
+    }
+    return Aabb{x - half_width, y - half_height, x + half_width,
+                y + half_height};
+  }
+};
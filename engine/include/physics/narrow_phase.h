@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "physics/collision_shape.h"
+
+// Batched overlap tests. Candidate pairs are sorted into one structure of
+// arrays per shape combination and tested four at a time with SSE2 or NEON,
+// with a scalar loop for the tail and for other targets. Distances are
+// compared squared so no test needs a sqrt.
+class NarrowPhase {
+public:
+  void clear();
+
+  // pair is an id of the caller's choosing, reported back by run
+  void add(uint32_t pair, const CollisionShape& a, const CollisionShape& b);
+  inline size_t size() const {
+    return m_rect_rect.pair.size() + m_circle_circle.pair.size() +
+           m_rect_circle.pair.size();
+  }
+
+  // appends the ids of the overlapping pairs to the output, grouped by shape
+  // combination
+  void run(std::vector<uint32_t>& overlapping) const;
+
+  // the same tests for a single pair
+  static bool overlaps(const CollisionShape& a, const CollisionShape& b);
+
+private:
+  struct RectRectBatch {
+    std::vector<float> dx, dy;  // center offsets
+    std::vector<float> sum_half_width, sum_half_height;
+    std::vector<uint32_t> pair;
+  };
+
+  struct CircleCircleBatch {
+    std::vector<float> dx, dy;
+    std::vector<float> sum_radius;
+    std::vector<uint32_t> pair;
+  };
+
+  // circle center relative to the rectangle center
+  struct RectCircleBatch {
+    std::vector<float> dx, dy;
+    std::vector<float> half_width, half_height;
+    std::vector<float> radius;
+    std::vector<uint32_t> pair;
+  };
+
+  void run_rect_rect(std::vector<uint32_t>& overlapping) const;
+  void run_circle_circle(std::vector<uint32_t>& overlapping) const;
+  void run_rect_circle(std::vector<uint32_t>& overlapping) const;
+
+  RectRectBatch m_rect_rect;
+  CircleCircleBatch m_circle_circle;
+  RectCircleBatch m_rect_circle;
+};
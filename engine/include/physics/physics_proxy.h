@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// A collider's slot in the physics world. Copies start out unregistered, the
+// storage copies variants around and the proxy belongs to the original.
+class PhysicsProxy {
+public:
+  static constexpr int32_t k_none = -1;
+
+  PhysicsProxy() = default;
+  PhysicsProxy(const PhysicsProxy&) {}
+  PhysicsProxy& operator=(const PhysicsProxy&) { return *this; }
+
+  int32_t id = k_none;
+};
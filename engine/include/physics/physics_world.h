@@ -0,0 +1,271 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/macros.h"
+#include "entity/entity.h"
+#include "physics/aabb.h"
+#include "physics/aabb_tree.h"
+#include "physics/collision_shape.h"
+#include "physics/narrow_phase.h"
+#include "physics/spatial_hash.h"
+
+class Collider;
+
+// Runs the simulation in fixed steps on a worker thread and turns the pairs
+// that touched during a frame into enter, stay and exit events. A body is an
+// entity with a Velocity and a non static Collider, fast circles are swept so
+// they can't tunnel through thin colliders and triggers only report contacts.
+class PhysicsWorld {
+  MAKE_SINGLETON(PhysicsWorld);
+
+public:
+  struct RaycastResult {
+    Collider* collider = nullptr;
+    float fraction = 1.0f;  // along the segment
+    float normal_x = 0.0f;
+    float normal_y = 0.0f;
+  };
+
+  // the sync point at the start of the play update. waits for the job of the
+  // last frame, syncs the broad phase with the storage, writes the simulated
+  // transforms back to Position and Velocity, sends the contact events and
+  // starts the next job on a snapshot. the worker never touches the storage,
+  // so handlers and scripts see the physics one frame behind, and a body a
+  // script moved during the frame keeps what the script wrote. steps come
+  // from an accumulator, a frame that ran none sends no events
+  void step(float frame_time);
+  void clear();
+
+  // syncs the broad phase with the storage without simulating, so the
+  // queries below keep working while the play update doesn't run
+  void sync();
+
+  // static colliders are rebuilt from their current positions next update,
+  // for when one was moved anyway
+  inline void invalidate_static() { m_static_dirty = true; }
+
+  // calls fn(Collider&) for every collider whose broad phase bounds overlap
+  // the box, these are as of the last sync and may be fattened
+  template <typename F>
+  void query(const Aabb& box, F&& fn) const {
+    visit_published(
+        box, [&](uint32_t proxy) { fn(*m_proxies[proxy].collider); });
+  }
+
+  // same as query, also hands over the collider's shape. static shapes come
+  // from the cache, moving ones are resolved against their current position
+  template <typename F>
+  void query_shapes(const Aabb& box, F&& fn) const {
+    visit_published(box, [&](uint32_t id) {
+      const Proxy& proxy = m_proxies[id];
+      fn(*proxy.collider, proxy.is_static ? proxy.shape
+                                          : resolve_shape(*proxy.collider));
+    });
+  }
+
+  // the queries behind Query::raycast and friends. they only see colliders
+  // with a category in layers and skip the ones that were disabled or removed
+  // since the last sync
+
+  // closest collider the segment from (x, y) to (x + dx, y + dy) hits
+  bool raycast(float x, float y, float dx, float dy, uint32_t layers,
+               RaycastResult& result) const;
+  void overlap(const CollisionShape& shape, uint32_t layers,
+               std::vector<Collider*>& colliders) const;
+  // up to count colliders closest to the point, closest first
+  void nearest(float x, float y, size_t count, uint32_t layers,
+               std::vector<Collider*>& colliders) const;
+
+  inline size_t get_collider_count() const { return m_proxy_count; }
+  inline size_t get_contact_count() const { return m_contact_count; }
+  inline float get_fixed_delta() const { return m_fixed_delta; }
+  inline size_t get_static_count() const {
+    return m_static_tree.get_proxy_count();
+  }
+
+private:
+  PhysicsWorld();
+  ~PhysicsWorld();
+
+  struct Proxy {
+    Collider* collider = nullptr;  // nullptr while on the free list
+    entity_id entity = 0;
+    int32_t node = AabbTree::k_null;
+    uint32_t seen_frame = 0;
+    uint32_t serial = 0;  // unique per proxy, ids are reused
+    bool is_static = false;
+    bool is_trigger = false;
+    bool is_listening = false;  // collider has contact listeners
+    bool is_body = false;
+    uint32_t category = 1;
+    uint32_t mask = ~0u;  // the collider's mask and the layer matrix
+
+    // shape the proxy was created with, a size change means a new proxy.
+    // only static proxies keep the position up to date
+    CollisionShape shape;
+  };
+
+  // an overlapping pair, a is the proxy with the lower serial
+  struct Contact {
+    uint64_t key;  // both serials
+    Collider* a;
+    Collider* b;
+    int32_t proxy_a;  // only valid during the job that found it
+    int32_t proxy_b;
+  };
+
+  struct ContactEvent {
+    enum Kind { Enter, Stay, Exit };
+
+    Kind kind;
+    Collider* a;
+    Collider* b;
+  };
+
+  // simulated state of a body, start_* is what the snapshot read so the sync
+  // can tell whether a script wrote to it in the meantime
+  struct Body {
+    int32_t proxy;
+    uint32_t serial;
+    float start_x, start_y;
+    float start_vx, start_vy;
+    float vx, vy;
+  };
+
+  // calls fn(proxy id) for the proxies overlapping the box
+  template <typename F>
+  void visit(const AabbTree& dynamic_tree, const SpatialHash& grid,
+             const std::vector<uint32_t>& grid_proxies, const Aabb& box,
+             F&& fn) const {
+    m_static_tree.query(box, fn);
+    if (m_use_grid) {
+      grid.query(box, [&](uint32_t i) { fn(grid_proxies[i]); });
+    } else {
+      dynamic_tree.query(box, fn);
+    }
+  }
+
+  // what the job works on
+  template <typename F>
+  void visit_proxies(const Aabb& box, F&& fn) const {
+    visit(m_dynamic_tree, m_grid, m_grid_proxies, box, fn);
+  }
+
+  // copies of the dynamic broad phase taken at the sync, for the main thread
+  template <typename F>
+  void visit_published(const Aabb& box, F&& fn) const {
+    visit(m_published_tree, m_published_grid, m_published_grid_proxies, box,
+          fn);
+  }
+
+  static CollisionShape resolve_shape(const Collider& collider);
+
+  inline static bool can_collide(const Proxy& a, const Proxy& b) {
+    return (a.category & b.mask) && (b.category & a.mask);
+  }
+  // the layers a collider of these categories meets, combined with its own
+  // mask. pairs are filtered by it before any geometry is looked at
+  uint32_t layer_mask(uint32_t category) const;
+
+  // for the main thread, nullptr when the collider is gone or disabled
+  Collider* live_collider(uint32_t id, uint32_t layers) const;
+  inline const CollisionShape& get_shape(int32_t id) const {
+    return m_proxies[id].is_static ? m_proxies[id].shape : m_shapes[id];
+  }
+
+  // main thread, while the worker is idle
+  void update_broad_phase();
+  void publish_results();
+  bool dispatch_events();  // false when there was nothing to send
+  void drop_disabled();
+  void take_snapshot();
+
+  // worker thread
+  void simulate(float frame_time);
+  void fixed_step();
+  void refit_dynamic();
+  void integrate(float delta);
+  float sweep_circle(int32_t proxy, float x, float y, float dx,
+                     float dy) const;
+  void find_contacts();
+  void resolve_contacts();
+  void resolve(int32_t body_proxy, int32_t other_proxy);
+  void collect_contacts();
+  void record_events();
+
+  void start_job(float frame_time);
+  void wait_for_job();
+  void worker_loop();
+
+  int32_t create_proxy(Collider& collider);
+  void destroy_proxy(int32_t id);
+  bool matches(const Proxy& proxy, const Collider& collider) const;
+  void refresh_static();
+  float derive_cell_size() const;
+
+  std::vector<Proxy> m_proxies;
+  std::vector<int32_t> m_free_proxies;
+  size_t m_proxy_count = 0;
+  uint32_t m_frame = 0;
+  uint32_t m_next_serial = 0;
+
+  // of the last substep, sorted by key
+  std::vector<Contact> m_contacts;
+  // every pair of the substeps of a job, and of the last job that ran a step
+  std::vector<Contact> m_frame_contacts;
+  std::vector<Contact> m_previous_contacts;
+  std::vector<Contact> m_candidates;
+  std::vector<uint32_t> m_hits;
+  std::vector<ContactEvent> m_events;  // filled by the job, sent at the sync
+  std::vector<Collider*> m_removed;    // left the storage since the last sync
+  size_t m_contact_count = 0;
+
+  // static colliders are assumed not to move, their tree is only touched when
+  // one appears, disappears or changes shape. moving ones are reinserted once
+  // they leave their fat bounds, or live in the grid when it is in use
+  AabbTree m_static_tree;
+  AabbTree m_dynamic_tree;
+  bool m_static_dirty = false;
+
+  std::vector<int32_t> m_dynamic_proxies;
+  std::vector<Body> m_bodies;
+  std::vector<int32_t> m_body_of_proxy;  // -1 for proxies that aren't bodies
+
+  // moving shapes as of the snapshot, advanced by the job
+  std::vector<CollisionShape> m_shapes;
+
+  // dynamic colliders when the grid is in use, rebuilt every substep
+  SpatialHash m_grid;
+  std::vector<uint32_t> m_grid_proxies;
+  std::vector<Aabb> m_grid_bounds;
+
+  AabbTree m_published_tree;
+  SpatialHash m_published_grid;
+  std::vector<uint32_t> m_published_grid_proxies;
+
+  NarrowPhase m_narrow_phase;
+
+  float m_accumulator = 0.0f;
+  float m_fixed_delta = 1.0f / 60.0f;
+  int m_substeps = 2;
+  int m_max_steps = 5;  // per frame, the rest is dropped after a hitch
+
+  static constexpr int k_layer_count = 32;
+  uint32_t m_layer_masks[k_layer_count];
+
+  bool m_use_grid = false;
+  float m_fixed_cell_size = 0.0f;  // 0 derives it from the collider extents
+
+  // started with the first job
+  bool m_threaded = true;
+  std::thread m_worker;
+  std::mutex m_job_mutex;
+  std::condition_variable m_job_cv;
+  bool m_job_pending = false;
+  bool m_worker_running = true;
+  float m_job_frame_time = 0.0f;
+};
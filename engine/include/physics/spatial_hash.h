@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "physics/aabb.h"
+
+// Uniform grid broad phase. Cells are hashed into a flat bucket table that is
+// rebuilt from scratch every build with a counting sort, so there are no
+// per-cell allocations once the buffers have grown to the scene size.
+// Proxies are identified by their index in the bounds passed to build.
+class SpatialHash {
+public:
+  void set_cell_size(float cell_size);
+  inline float get_cell_size() const { return m_cell_size; }
+
+  void build(const std::vector<Aabb>& bounds);
+  void clear();
+
+  inline size_t get_proxy_count() const { return m_bounds.size(); }
+  inline const Aabb& get_bounds(uint32_t proxy) const {
+    return m_bounds[proxy];
+  }
+
+  // calls fn(proxy) once for every proxy whose bounds overlap the box.
+  // not reentrant, fn must not start another query on the same grid
+  template <typename F>
+  void query(const Aabb& box, F&& fn) const {
+    if (m_bounds.empty()) return;
+    next_stamp();
+
+    for (uint32_t proxy : m_oversized) {
+      if (m_bounds[proxy].overlaps(box)) fn(proxy);
+    }
+
+    CellRange range = cell_range(box);
+    if (range.count() > m_entries.size()) {
+      // cheaper to walk every entry than to visit all those cells
+      for (const Entry& entry : m_entries) {
+        visit(entry.proxy, box, fn);
+      }
+      return;
+    }
+
+    for (int32_t y = range.min_y; y <= range.max_y; y++) {
+      for (int32_t x = range.min_x; x <= range.max_x; x++) {
+        uint64_t cell = cell_key(x, y);
+        size_t bucket = bucket_index(cell);
+
+        for (uint32_t i = m_bucket_start[bucket];
+             i < m_bucket_start[bucket + 1]; i++) {
+          if (m_entries[i].cell == cell) visit(m_entries[i].proxy, box, fn);
+        }
+      }
+    }
+  }
+
+  // calls fn(a, b) once for every pair of proxies with overlapping bounds,
+  // a is always the lower index
+  template <typename F>
+  void for_each_pair(F&& fn) const {
+    for (uint32_t a = 0; a < m_bounds.size(); a++) {
+      query(m_bounds[a], [&](uint32_t b) {
+        if (a < b) fn(a, b);
+      });
+    }
+  }
+
+private:
+  struct Entry {
+    uint64_t cell;
+    uint32_t proxy;
+  };
+
+  struct CellRange {
+    int32_t min_x, min_y, max_x, max_y;
+
+    inline size_t count() const {
+      return size_t(max_x - min_x + 1) * size_t(max_y - min_y + 1);
+    }
+  };
+
+  CellRange cell_range(const Aabb& box) const;
+  int32_t cell_coord(float value) const;
+
+  static inline uint64_t cell_key(int32_t x, int32_t y) {
+    return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+  }
+
+  inline size_t bucket_index(uint64_t cell) const {
+    return size_t((cell * 0x9E3779B97F4A7C15ull) >> (64 - m_bucket_bits));
+  }
+
+  template <typename F>
+  inline void visit(uint32_t proxy, const Aabb& box, F& fn) const {
+    if (m_stamps[proxy] == m_stamp) return;
+    m_stamps[proxy] = m_stamp;
+    if (m_bounds[proxy].overlaps(box)) fn(proxy);
+  }
+
+  void next_stamp() const;
+
+  float m_cell_size = 64.0f;
+  float m_inv_cell_size = 1.0f / 64.0f;
+
+  std::vector<Aabb> m_bounds;
+  std::vector<Entry> m_entries;  // sorted by bucket
+  std::vector<Entry> m_scratch;
+  std::vector<uint32_t> m_bucket_start;
+  std::vector<uint32_t> m_oversized;  // proxies spanning too many cells
+  uint32_t m_bucket_bits = 4;
+
+  // marks proxies already reported by the current query, a proxy sits in
+  // every cell its bounds touch
+  mutable std::vector<uint32_t> m_stamps;
+  mutable uint32_t m_stamp = 0;
+};
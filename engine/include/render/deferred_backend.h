@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "render/render_backend.h"
+
+// Records the draw calls of a frame, vertices and text included, to replay
+// them on another backend later. It lets the render thread prepare a frame
+// while the gl context stays with the main thread, which replays it. Nothing
+// is loaded through it, textures and render textures are made on the main
+// thread before they are drawn with.
+class DeferredBackend : public RenderBackend {
+public:
+  void clear();
+  // in the order they were recorded, the recording stays
+  void replay(RenderBackend& backend) const;
+
+  inline bool empty() const { return m_calls.empty(); }
+
+  void begin_drawing() override;
+  void end_drawing() override;
+  void begin_mode2d(const Camera2D& camera) override;
+  void end_mode2d() override;
+  void begin_texture_mode(const RenderTexture2D& target) override;
+  void end_texture_mode() override;
+  void begin_scissor_mode(int x, int y, int width, int height) override;
+  void end_scissor_mode() override;
+  void clear_background(Color color) override;
+
+  void draw_line(Vector2 start, Vector2 end, Color color) override;
+  void draw_circle(Vector2 center, float radius, Color color) override;
+  void draw_circle_lines(Vector2 center, float radius, Color color) override;
+  void draw_rectangle(Rectangle rect, Color color) override;
+  void draw_rectangle_lines(Rectangle rect, float thickness,
+                            Color color) override;
+  void draw_text(const char* text, Vector2 position, int font_size,
+                 Color color) override;
+  void draw_texture(const Texture2D& texture, Rectangle source,
+                    Rectangle dest, Vector2 origin, float rotation,
+                    Color tint) override;
+  void draw_triangles(unsigned int texture, const RenderVertex* vertices,
+                      size_t count) override;
+
+  // not recordable, they need an answer now
+  Texture2D load_texture(const char* path) override;
+  Texture2D load_texture_from_image(const Image& image) override;
+  void update_texture(const Texture2D& texture, const void* pixels) override;
+  void unload_texture(const Texture2D& texture) override;
+  RenderTexture2D load_render_texture(int width, int height) override;
+  void unload_render_texture(const RenderTexture2D& target) override;
+  Font get_font_default() override;
+
+private:
+  enum class Op : uint8_t {
+    BeginDrawing,
+    EndDrawing,
+    BeginMode2D,
+    EndMode2D,
+    BeginTextureMode,
+    EndTextureMode,
+    BeginScissorMode,
+    EndScissorMode,
+    ClearBackground,
+    Line,
+    Circle,
+    CircleLines,
+    Rectangle,
+    RectangleLines,
+    Text,
+    Texture,
+    Triangles
+  };
+
+  // what every call needs fits in one, the unused fields stay zero
+  struct Call {
+    Op op;
+    Color color;
+    ::Rectangle rect;    // rectangles, the dest of textures, scissor box
+    ::Rectangle source;  // textures
+    Vector2 point;       // line start, circle center, text position, origin
+    Vector2 end;         // line end
+    float value;         // radius, thickness, rotation, font size
+    Camera2D camera;
+    RenderTexture2D target;
+    Texture2D texture;  // the id alone for triangles
+    size_t first;       // into m_vertices or m_text
+    size_t count;
+  };
+
+  Call& push(Op op);
+
+  std::vector<Call> m_calls;
+  std::vector<RenderVertex> m_vertices;
+  std::string m_text;  // every string, each ending in '\0'
+};
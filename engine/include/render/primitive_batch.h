@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "raylib.h"
+#include "render/render_backend.h"
+
+// Builds the triangles of filled and outlined rectangles and circles, sprites
+// and glyphs on the cpu and hands them to the render backend in large runs,
+// so a wall of shapes costs a few draw calls instead of a raylib call per
+// shape. The geometry matches what the raylib functions of the same name
+// draw, outlined circles are a one pixel ring instead of gl lines so they
+// stay triangles.
+//
+// Everything is drawn in the order it was added. Shapes use the default
+// texture, adding something with another texture flushes what was added
+// before, so callers sort by texture to keep the runs long.
+class PrimitiveBatch {
+public:
+  PrimitiveBatch();
+
+  void add_rectangle(Rectangle rect, Color color);
+  // the lines are drawn inside the rectangle like DrawRectangleLinesEx
+  void add_rectangle_lines(Rectangle rect, float thickness, Color color);
+  void add_circle(Vector2 center, float radius, Color color);
+  void add_circle_lines(Vector2 center, float radius, Color color);
+  // same arguments as DrawTexturePro
+  void add_texture(const Texture2D& texture, Rectangle source, Rectangle dest,
+                   Vector2 origin, float rotation, Color tint);
+
+  void flush();
+
+  inline bool empty() const { return m_vertices.empty(); }
+
+private:
+  static constexpr int k_circle_segments = 36;  // like DrawCircleV
+
+  // flushes when the texture changes, 0 is the default texture
+  inline void use_texture(unsigned int texture) {
+    if (texture != m_texture) {
+      flush();
+      m_texture = texture;
+    }
+  }
+
+  // counter clockwise on screen, rlgl culls the other side
+  void add_quad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, Color color);
+  inline void add_vertex(Vector2 point, Color color) {
+    m_vertices.push_back(RenderVertex{point.x, point.y, 0.0f, 0.0f, color});
+  }
+
+  std::vector<RenderVertex> m_vertices;  // three per triangle
+  unsigned int m_texture = 0;
+  float m_cos[k_circle_segments + 1];
+  float m_sin[k_circle_segments + 1];
+};
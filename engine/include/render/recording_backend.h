@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "render/render_backend.h"
+
+struct RecordedDraw {
+  enum Type {
+    Line,
+    Circle,
+    CircleLines,
+    Rectangle,
+    RectangleLines,
+    Text,
+    Texture,
+    Triangles,
+  };
+
+  Type type;
+  // in the coordinates the draw was given, world or screen
+  ::Rectangle bounds;
+  unsigned int texture;  // 0 for plain shapes and text
+  unsigned int target;   // render texture id, 0 for the screen
+  size_t vertex_count;   // triangles only
+};
+
+// Null backend for headless runs. It records every draw instead of issuing
+// it and hands out made up texture ids, nothing needs a window or a gpu.
+// Frames are counted by end_drawing, clear() starts over.
+class RecordingBackend : public RenderBackend {
+public:
+  void clear();
+
+  inline const std::vector<RecordedDraw>& get_draws() const {
+    return m_draws;
+  }
+  size_t get_draw_count(RecordedDraw::Type type) const;
+  inline size_t get_frame_count() const { return m_frame_count; }
+  // textures and render textures loaded and not unloaded yet
+  inline size_t get_texture_count() const { return m_texture_count; }
+  // textured draws using another texture than the one before, what rlgl
+  // starts a new draw call for
+  inline size_t get_texture_switch_count() const {
+    return m_texture_switch_count;
+  }
+
+  void begin_drawing() override {}
+  void end_drawing() override { m_frame_count++; }
+  void begin_mode2d(const Camera2D&) override {}
+  void end_mode2d() override {}
+  void begin_texture_mode(const RenderTexture2D& target) override;
+  void end_texture_mode() override { m_target = 0; }
+  void begin_scissor_mode(int, int, int, int) override {}
+  void end_scissor_mode() override {}
+  void clear_background(Color) override {}
+
+  void draw_line(Vector2 start, Vector2 end, Color color) override;
+  void draw_circle(Vector2 center, float radius, Color color) override;
+  void draw_circle_lines(Vector2 center, float radius, Color color) override;
+  void draw_rectangle(Rectangle rect, Color color) override;
+  void draw_rectangle_lines(Rectangle rect, float thickness,
+                            Color color) override;
+  void draw_text(const char* text, Vector2 position, int font_size,
+                 Color color) override;
+  void draw_texture(const Texture2D& texture, Rectangle source,
+                    Rectangle dest, Vector2 origin, float rotation,
+                    Color tint) override;
+  void draw_triangles(unsigned int texture, const RenderVertex* vertices,
+                      size_t count) override;
+
+  Texture2D load_texture(const char* path) override;
+  Texture2D load_texture_from_image(const Image& image) override;
+  void update_texture(const Texture2D&, const void*) override {}
+  void unload_texture(const Texture2D& texture) override;
+  RenderTexture2D load_render_texture(int width, int height) override;
+  void unload_render_texture(const RenderTexture2D& target) override;
+  // without glyphs, only its texture is real
+  Font get_font_default() override;
+
+private:
+  static constexpr unsigned int k_no_texture = ~0u;
+
+  void record(RecordedDraw::Type type, Rectangle bounds,
+              unsigned int texture = 0, size_t vertex_count = 0);
+  Texture2D make_texture(int width, int height);
+
+  std::vector<RecordedDraw> m_draws;
+  Font m_font = {};
+  unsigned int m_next_id = 1;
+  unsigned int m_target = 0;
+  unsigned int m_texture = k_no_texture;  // of the last draw
+  size_t m_frame_count = 0;
+  size_t m_texture_count = 0;
+  size_t m_texture_switch_count = 0;
+};
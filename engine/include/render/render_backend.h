@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include "raylib.h"
+
+// a vertex of the triangles a PrimitiveBatch hands over
+struct RenderVertex {
+  float x, y;
+  float u, v;
+  Color color;
+};
+
+// What the drawing and gpu resource functions of raylib_wrapper.h go
+// through. The default backend forwards to raylib and needs a window, a
+// RecordingBackend set in its place lets benchmarks and tests run whole
+// frames without one.
+class RenderBackend {
+public:
+  virtual ~RenderBackend() = default;
+
+  // the raylib backend unless another one was set
+  static RenderBackend& get();
+  // not owned, nullptr goes back to raylib. set it before anything is loaded,
+  // textures don't move between backends, and keep it alive until the
+  // singletons that loaded through it are gone
+  static void set(RenderBackend* backend);
+  // for the calling thread only, over the one set for all. nullptr drops it
+  static void set_for_thread(RenderBackend* backend);
+
+  virtual void begin_drawing() = 0;
+  virtual void end_drawing() = 0;
+  virtual void begin_mode2d(const Camera2D& camera) = 0;
+  virtual void end_mode2d() = 0;
+  virtual void begin_texture_mode(const RenderTexture2D& target) = 0;
+  virtual void end_texture_mode() = 0;
+  virtual void begin_scissor_mode(int x, int y, int width, int height) = 0;
+  virtual void end_scissor_mode() = 0;
+  virtual void clear_background(Color color) = 0;
+
+  virtual void draw_line(Vector2 start, Vector2 end, Color color) = 0;
+  virtual void draw_circle(Vector2 center, float radius, Color color) = 0;
+  virtual void draw_circle_lines(Vector2 center, float radius,
+                                 Color color) = 0;
+  virtual void draw_rectangle(Rectangle rect, Color color) = 0;
+  virtual void draw_rectangle_lines(Rectangle rect, float thickness,
+                                    Color color) = 0;
+  virtual void draw_text(const char* text, Vector2 position, int font_size,
+                         Color color) = 0;
+  // same arguments as DrawTexturePro
+  virtual void draw_texture(const Texture2D& texture, Rectangle source,
+                            Rectangle dest, Vector2 origin, float rotation,
+                            Color tint) = 0;
+  // three vertices per triangle, texture 0 is the white default texture
+  virtual void draw_triangles(unsigned int texture,
+                              const RenderVertex* vertices, size_t count) = 0;
+
+  virtual Texture2D load_texture(const char* path) = 0;
+  virtual Texture2D load_texture_from_image(const Image& image) = 0;
+  // pixels in the texture's format, for all of it
+  virtual void update_texture(const Texture2D& texture,
+                              const void* pixels) = 0;
+  virtual void unload_texture(const Texture2D& texture) = 0;
+  virtual RenderTexture2D load_render_texture(int width, int height) = 0;
+  virtual void unload_render_texture(const RenderTexture2D& target) = 0;
+  // a font without glyphs when there is none
+  virtual Font get_font_default() = 0;
+};
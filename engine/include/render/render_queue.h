@@ -0,0 +1,210 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/macros.h"
+#include "raylib.h"
+#include "render/deferred_backend.h"
+#include "render/primitive_batch.h"
+#include "render/sprite_batch.h"
+#include "render/text_cache.h"
+
+// Per frame list of draw commands. Update hooks describe what they draw
+// instead of calling raylib, and Zeytin submits the whole frame once at the
+// end of the update passes. World commands are drawn with the camera, screen
+// commands without it, and nothing off screen is sorted or drawn.
+class RenderQueue {
+  MAKE_SINGLETON(RenderQueue);
+
+public:
+  enum class Space : uint8_t { World = 0, Screen = 1 };
+
+  // above anything a scene uses, for editor overlays
+  static constexpr int k_top_layer = INT16_MAX;
+
+  // commands queued while one is alive go to the static layer of their space,
+  // a render texture composited under everything else of the space. it only
+  // redraws the region of the commands that came or went, clipped with a
+  // scissor. the world layer is drawn render_static_margin pixels larger than
+  // the view and is reused while the camera pans inside it
+  class StaticScope {
+  public:
+    explicit StaticScope(bool is_static = true);
+    ~StaticScope();
+
+  private:
+    bool m_previous;
+  };
+
+  inline void set_space(Space space) { m_space = space; }
+  // render_threaded of the config, for benchmarks and tests. a frame still
+  // waiting for its replay is drawn first
+  void set_threaded(bool threaded);
+
+  void draw_rectangle(Rectangle rect, Color color, int layer = 0,
+                      int depth = 0);
+  void draw_rectangle_lines(Rectangle rect, float thickness, Color color,
+                            int layer = 0, int depth = 0);
+  void draw_circle(Vector2 center, float radius, Color color, int layer = 0,
+                   int depth = 0);
+  void draw_circle_lines(Vector2 center, float radius, Color color,
+                         int layer = 0, int depth = 0);
+  // same arguments as DrawTexturePro
+  void draw_texture(const SpriteFrame& frame, Rectangle dest, Vector2 origin,
+                    float rotation, Color tint, int layer = 0, int depth = 0);
+  // like DrawText with the default font
+  void draw_text(const char* text, Vector2 position, float font_size,
+                 Color color, int layer = 0, int depth = 0);
+
+  // brings the static layers up to date, then clears the target and draws
+  // everything queued since the last submit that can be seen on it. clears
+  // the queue. threaded, it draws what was queued before the last submit
+  // instead and leaves this frame to the render thread, which culls, sorts
+  // and records it into a DeferredBackend while the next frame is simulated.
+  // the gl context stays with the main thread, the next submit replays it
+  void submit(const RenderTexture2D& target, const Camera2D& camera,
+              Color background);
+
+  // unloads the texture once no queued or recorded frame can draw it anymore,
+  // right away when there is no queue, before the first frame or at exit.
+  // threaded, frames are drawn a submit late, so released textures can't be
+  // unloaded right away
+  static void retire_texture(const Texture2D& texture);
+
+  // of the last frame drawn, the commands drawn and the ones culled
+  inline size_t get_command_count() const { return m_stats.command_count; }
+  inline size_t get_culled_count() const { return m_stats.culled_count; }
+  // texture switches and space switches of the last frame drawn
+  inline size_t get_state_changes() const { return m_stats.state_changes; }
+  // static commands of the last frame drawn and the layer redraws they
+  // caused, whole or partial
+  inline size_t get_static_count() const { return m_stats.static_count; }
+  inline size_t get_static_redraw_count() const {
+    return m_stats.static_redraw_count;
+  }
+
+private:
+  RenderQueue();
+  ~RenderQueue();
+
+  enum class Kind : uint8_t {
+    Rectangle,
+    RectangleLines,
+    Circle,
+    CircleLines,
+    Texture,
+    Text
+  };
+
+  struct Command {
+    uint64_t key;
+    Kind kind;
+    Color color;
+    Rectangle bounds;  // in the command's space
+    // circles keep the center in x, y and the radius in width
+    Rectangle rect;
+    float thickness;  // of lines
+    // textures only
+    Texture2D texture;
+    Rectangle source;
+    Vector2 origin;
+    float rotation;
+    const TextRun* run;  // text only
+    bool is_static;
+  };
+
+  struct StaticEntry {
+    uint64_t hash;  // of everything the command draws
+    Rectangle bounds;
+  };
+
+  struct StaticLayer {
+    RenderTexture2D target = {};
+    Camera2D camera = {};  // it was drawn with
+    bool is_valid = false;
+    std::vector<StaticEntry> entries;  // what it shows, sorted by hash
+  };
+
+  // a frame as the simulation left it
+  struct FramePacket {
+    std::vector<Command> commands;
+    RenderTexture2D target = {};
+    Camera2D camera = {};
+    Color background = {};
+  };
+
+  struct Stats {
+    size_t command_count = 0;
+    size_t culled_count = 0;
+    size_t state_changes = 0;
+    size_t static_count = 0;
+    size_t static_redraw_count = 0;
+  };
+
+  // space, layer, depth and material, highest bits first. sorting by it
+  // draws lower layers first and groups commands sharing a texture into one
+  // batch, commands with the same key keep their submission order
+  uint64_t make_key(int layer, int depth, uint32_t material) const;
+  Command& push(Kind kind, Rectangle bounds, Color color, int layer, int depth,
+                uint32_t material);
+  void execute(const Command& command);
+  static uint64_t hash(const Command& command);
+
+  // main thread, while the render thread is idle
+  void prepare_static_layers(int width, int height);
+  void unload_retired(std::vector<Texture2D>& textures);
+  void start_job(int frame);
+  void wait_for_job();
+
+  // render thread, or the submit when not threaded
+  void draw_packet();
+  void worker_loop();
+  void update_static_layer(StaticLayer& layer,
+                           const std::vector<uint32_t>& order,
+                           const Camera2D& camera, int margin);
+  // the whole layer, or only the part of it within region
+  void redraw_static_layer(StaticLayer& layer,
+                           const std::vector<uint32_t>& order,
+                           const Rectangle* region);
+  void composite(const StaticLayer& layer, const Camera2D& camera);
+
+  Space m_space = Space::World;
+  bool m_static = false;
+  std::vector<Command> m_commands;  // queued since the last submit
+
+  FramePacket m_packet;
+  // indices into the packet's commands per space, sorted by key
+  std::vector<uint32_t> m_order[2];
+  std::vector<uint32_t> m_static_order[2];
+
+  bool m_use_static_layers = true;
+  int m_static_margin = 128;
+  StaticLayer m_static_layers[2];
+  std::vector<StaticEntry> m_static_entries;
+  // layers replaced while a recorded frame may still draw them
+  std::vector<RenderTexture2D> m_retired_layers;
+  std::vector<Texture2D> m_retired_textures;   // since the last submit
+  std::vector<Texture2D> m_retiring_textures;  // until the packet is replayed
+  PrimitiveBatch m_primitives;
+  TextCache m_text_cache;
+
+  Stats m_stats;      // for the main thread
+  Stats m_job_stats;  // of the packet being drawn
+
+  // the render thread records into one while the other is replayed
+  DeferredBackend m_frames[2];
+  int m_recording = 0;
+  bool m_has_recorded = false;
+
+  // started with the first job
+  bool m_threaded = true;
+  std::thread m_worker;
+  std::mutex m_job_mutex;
+  std::condition_variable m_job_cv;
+  bool m_job_pending = false;
+  bool m_worker_running = true;
+  int m_job_frame = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/macros.h"
+#include "raylib.h"
+#include "render/texture_atlas.h"
+#include "resource_manager/resource_manager.h"
+
+// a texture and the part of it a sprite shows. images of their own keep
+// their cached texture alive through the handle, atlas pages live as long as
+// the batch
+struct SpriteFrame {
+  Texture2D texture = {};
+  Rectangle source = {};
+  TextureHandle handle;
+};
+
+// Loads the images sprites draw. Small ones are packed into shared atlas
+// pages, which lets most sprites share a texture so RenderQueue can draw runs
+// of them as one rlgl batch instead of one draw call each.
+class SpriteBatch {
+  MAKE_SINGLETON(SpriteBatch);
+
+public:
+  // images up to k_max_atlas_image on both sides go to an atlas page, bigger
+  // ones get their own texture from the ResourceManager cache
+  static constexpr int k_max_atlas_image = 256;
+
+  bool load(const std::string& path, SpriteFrame& frame);
+
+  // sends images added to the atlas pages since the last call to the gpu
+  void upload();
+
+  inline size_t get_atlas_page_count() const { return m_pages.size(); }
+
+private:
+  SpriteBatch() = default;
+  ~SpriteBatch() = default;
+
+  std::vector<std::unique_ptr<TextureAtlas>> m_pages;
+  std::unordered_map<std::string, SpriteFrame> m_atlas_frames;
+};
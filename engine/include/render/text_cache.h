@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "raylib.h"
+
+// a glyph quad relative to where the text is drawn, source is in pixels of
+// the font texture
+struct TextGlyph {
+  Rectangle dest;
+  Rectangle source;
+};
+
+// a string laid out with the default font the way DrawText would
+struct TextRun {
+  std::vector<TextGlyph> glyphs;
+  Texture2D texture = {};
+  float width = 0.0f;
+  float height = 0.0f;
+  uint32_t last_used = 0;  // frame
+};
+
+// Lays out every string and font size once and hands the same glyph quads
+// out every frame after, DrawText measures and looks up every glyph on every
+// call. Labels sharing a text share the run, a thousand bricks with the same
+// health are one layout. Runs that weren't drawn for a while are dropped.
+class TextCache {
+public:
+  // valid until the next end_frame
+  const TextRun& get(const char* text, float font_size);
+  void end_frame();
+
+  inline size_t get_run_count() const { return m_runs.size(); }
+  // layouts done in the last frame, cache misses
+  inline size_t get_layout_count() const { return m_layout_count; }
+
+private:
+  static constexpr uint32_t k_max_idle_frames = 120;
+  static constexpr uint32_t k_prune_interval = 60;
+
+  static void layout(const char* text, int font_size, TextRun& run);
+
+  std::unordered_map<std::string, TextRun> m_runs;  // text and font size
+  std::string m_key;
+  uint32_t m_frame = 0;
+  size_t m_layouts = 0;  // since the last end_frame
+  size_t m_layout_count = 0;
+};
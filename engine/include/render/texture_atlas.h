@@ -0,0 +1,37 @@
+#pragma once
+
+#include "raylib.h"
+
+// One page of small images packed into a single texture, so sprites using
+// them can be drawn without switching textures. Images are placed left to
+// right on shelves as tall as the tallest image on them, and never move once
+// placed. The copy in memory is uploaded on the next upload() after a change.
+class TextureAtlas {
+public:
+  static constexpr int k_default_size = 2048;
+  static constexpr int k_padding = 2;  // keeps filtering from bleeding
+
+  explicit TextureAtlas(int size = k_default_size);
+  ~TextureAtlas();
+
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+  // copies the image in and hands back where it went, false when it doesn't
+  // fit on this page
+  bool add(const Image& image, Rectangle& region);
+  void upload();
+
+  inline const Texture2D& get_texture() const { return m_texture; }
+  inline int get_size() const { return m_size; }
+
+private:
+  int m_size;
+  Image m_image;
+  Texture2D m_texture;
+  bool m_dirty = false;
+
+  int m_shelf_x = 0;
+  int m_shelf_y = 0;
+  int m_shelf_height = 0;
+};
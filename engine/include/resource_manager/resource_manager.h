@@ -1,13 +1,50 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include "core/macros.h"
+#include "raylib.h"
 
 #define ENTITY_FOLDER "entities"
 #define VARIANT_FOLDER "variants"
 #define ENGINE_SCRIPTS_FOLDER "scripts"
 
+struct CachedTexture;
+
+// Shared texture out of the ResourceManager cache. Copies share the texture,
+// which is unloaded once the last handle pointing at it is gone.
+class TextureHandle {
+public:
+  TextureHandle() = default;
+  TextureHandle(const TextureHandle& other);
+  TextureHandle(TextureHandle&& other) noexcept;
+  TextureHandle& operator=(const TextureHandle& other);
+  TextureHandle& operator=(TextureHandle&& other) noexcept;
+  ~TextureHandle();
+
+  const Texture2D& get() const;
+  inline bool is_valid() const { return m_texture != nullptr; }
+  inline explicit operator bool() const { return is_valid(); }
+
+  void reset();
+
+private:
+  friend class ResourceManager;
+  explicit TextureHandle(CachedTexture* texture);
+
+  CachedTexture* m_texture = nullptr;
+};
+
+struct TextureCacheStats {
+  size_t texture_count = 0;  // alive right now
+  size_t bytes = 0;          // of the alive textures, as uploaded
+  size_t loads = 0;
+  size_t hits = 0;
+  size_t unloads = 0;
+};
+
 class ResourceManager final {
   MAKE_SINGLETON(ResourceManager);
 
@@ -32,10 +69,31 @@ public:
   std::filesystem::path get_variant_path(const std::string& name) const;
   std::filesystem::path get_entity_path(const std::string& name) const;
 
+  // textures are cached by path, an invalid handle when loading failed
+  TextureHandle load_texture(const std::string& path);
+  // same, for callers that already decoded the image. it is only uploaded on
+  // a miss and stays owned by the caller
+  TextureHandle load_texture(const std::string& path, const Image& image);
+  // an invalid handle when the path isn't cached
+  TextureHandle find_texture(const std::string& path);
+
+  inline const TextureCacheStats& get_texture_stats() const {
+    return m_texture_stats;
+  }
+
 private:
+  friend class TextureHandle;
+
   ResourceManager();
+  ~ResourceManager();
+
+  TextureHandle add_texture(const std::string& path, Texture2D texture);
+  void release_texture(CachedTexture* texture);
 
   void construct_paths();
   std::filesystem::path get_search_start_dir() const;
   std::filesystem::path m_resources_path;
+
+  std::unordered_map<std::string, std::unique_ptr<CachedTexture>> m_textures;
+  TextureCacheStats m_texture_stats;
 };
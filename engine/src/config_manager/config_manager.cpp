@@ -10,6 +10,9 @@
 static const char* config_file = "config.json";
 
 ConfigManager::~ConfigManager() {
+  // headless runs have no window to remember and keep the config as it was
+  if (!IsWindowReady()) return;
+
   // we want to save window position in editor mode everytime
   int screen_width = GetScreenWidth();
   int screen_height = GetScreenHeight();
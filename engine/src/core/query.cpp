@@ -0,0 +1,84 @@
+#include "core/query.h"
+#include "game/collider.h"
+#include "physics/physics_world.h"
+
+namespace Query {
+
+static std::vector<std::reference_wrapper<Collider>> to_refs(
+    const std::vector<Collider*>& colliders) {
+  std::vector<std::reference_wrapper<Collider>> results;
+  results.reserve(colliders.size());
+  for (Collider* collider : colliders) {
+    results.push_back(std::ref(*collider));
+  }
+  return results;
+}
+
+static std::vector<std::reference_wrapper<Collider>> overlap(
+    const CollisionShape& shape, int layers) {
+  std::vector<Collider*> colliders;
+  PhysicsWorld::get().overlap(shape, (uint32_t)layers, colliders);
+  return to_refs(colliders);
+}
+
+std::optional<RaycastHit> raycast(Vector2 origin, Vector2 direction,
+                                  float max_distance, int layers) {
+  float length = Vector2Length(direction);
+  if (length == 0.0f || max_distance <= 0.0f) return std::nullopt;
+
+  float dx = direction.x / length * max_distance;
+  float dy = direction.y / length * max_distance;
+
+  PhysicsWorld::RaycastResult result;
+  if (!PhysicsWorld::get().raycast(origin.x, origin.y, dx, dy,
+                                   (uint32_t)layers, result)) {
+    return std::nullopt;
+  }
+
+  Vector2 point = {origin.x + dx * result.fraction,
+                   origin.y + dy * result.fraction};
+  return RaycastHit{std::ref(*result.collider), point,
+                    Vector2{result.normal_x, result.normal_y},
+                    result.fraction * max_distance};
+}
+
+std::vector<std::reference_wrapper<Collider>> overlap_point(Vector2 point,
+                                                            int layers) {
+  CollisionShape shape;
+  shape.type = CollisionShape::Circle;
+  shape.x = point.x;
+  shape.y = point.y;
+  return overlap(shape, layers);
+}
+
+std::vector<std::reference_wrapper<Collider>> overlap_rect(Rectangle rect,
+                                                           int layers) {
+  CollisionShape shape;
+  shape.type = CollisionShape::Rectangle;
+  shape.half_width = rect.width / 2;
+  shape.half_height = rect.height / 2;
+  shape.x = rect.x + shape.half_width;
+  shape.y = rect.y + shape.half_height;
+  return overlap(shape, layers);
+}
+
+std::vector<std::reference_wrapper<Collider>> overlap_circle(
+    Vector2 center, float radius, int layers) {
+  CollisionShape shape;
+  shape.type = CollisionShape::Circle;
+  shape.x = center.x;
+  shape.y = center.y;
+  shape.radius = radius;
+  return overlap(shape, layers);
+}
+
+std::vector<std::reference_wrapper<Collider>> nearest(Vector2 point,
+                                                      size_t count,
+                                                      int layers) {
+  std::vector<Collider*> colliders;
+  PhysicsWorld::get().nearest(point.x, point.y, count, (uint32_t)layers,
+                              colliders);
+  return to_refs(colliders);
+}
+
+}  // namespace Query
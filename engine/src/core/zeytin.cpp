@@ -15,10 +15,12 @@
 #include "core/utils.h"
 #include "editor/editor_event.h"
 #include "game/generated/rttr_registration.h"  // required for registering types
+#include "physics/physics_world.h"
 #include "rapidjson/document.h"
 #include "rapidjson/writer.h"
 #include "raylib.h"
 #include "remote_logger/remote_logger.h"
+#include "render/render_queue.h"
 #include "resource_manager/resource_manager.h"
 #include "variant/variant_base.h"
 
@@ -29,6 +31,7 @@ Zeytin::Zeytin() {
   while (!(m_editor_communication->is_connection_confirmed() &&
            is_scene_ready())) {
     m_editor_communication->raise_events();
+    EditorEventBus::get().flush();
     begin_drawing();  // temp black screen, otherwise may crash
     clear_background(BLACK);
     end_drawing();
@@ -54,31 +57,35 @@ Zeytin::Zeytin() {
 Zeytin::~Zeytin() {
 #ifdef EDITOR_MODE
   if (m_is_play_mode) exit_play_mode();  // for proper deinitialization
+  EditorEventBus::get().flush();            // pending logs
 #endif
 }
 
 void Zeytin::run_frame() {
 #ifdef EDITOR_MODE
   m_editor_communication->raise_events();
-#endif
+  EditorEventBus::get().flush();
+  if (m_is_play_mode) sync_editor();
 
-  begin_texture_mode(m_render_texture);
-  clear_background(RAYWHITE);
+  // keeps spatial queries working while nothing is simulated
+  if (!m_is_play_mode || m_is_pause_play_mode) PhysicsWorld::get().sync();
+#endif
 
-  begin_mode2d(m_camera);
+  // the hooks only queue draw commands, they're drawn at once below
+  auto& render_queue = RenderQueue::get();
+  render_queue.set_space(RenderQueue::Space::World);
 
   post_init_variants();
   update_variants();
 
-  end_mode2d();
-
   if (m_is_play_mode && !m_is_pause_play_mode) {
+    render_queue.set_space(RenderQueue::Space::Screen);
     play_start_variants();
     play_late_start_variants();
     play_update_variants();
   }
 
-  end_texture_mode();
+  render_queue.submit(m_render_texture, m_camera, RAYWHITE);
 
   begin_drawing();
   clear_background(BLACK);
@@ -131,7 +138,7 @@ entity_id Zeytin::zdeserialize_entity(const std::string& str) {
   return id;
 }
 
-std::string Zeytin::serialize_scene() {
+std::string Zeytin::serialize_scene(std::optional<uint64_t> sync_seq) {
   rapidjson::Document document;
   document.SetObject();
 
@@ -152,6 +159,9 @@ std::string Zeytin::serialize_scene() {
   }
 
   document.AddMember("type", "scene", allocator);
+  if (sync_seq) {
+    document.AddMember("sync_seq", *sync_seq, allocator);
+  }
   document.AddMember("entities", entitiesArray, allocator);
 
   rapidjson::StringBuffer buffer;
@@ -259,6 +269,8 @@ void Zeytin::update_variants() {
 void Zeytin::play_update_variants() {
   ZPROFILE_ZONE_NAMED("Zeytin::play_update_variants()");
 
+  PhysicsWorld::get().step(get_frame_time());
+
   for (auto& pair : m_storage) {
     for (auto& variant : pair.second) {
       VariantBase& base = variant.get_value<VariantBase&>();
@@ -348,52 +360,48 @@ void Zeytin::render() {
 #ifdef EDITOR_MODE
 
 void Zeytin::subscribe_editor_events() {
-  EditorEventBus::get().subscribe<const std::string&>(
-      EditorEvent::Scene, [this](const auto& scene) {
-        deserialize_scene(scene);
-        m_is_scene_ready = true;
-      });
+  auto& bus = EditorEventBus::get();
+
+  bus.subscribe<EditorEvent::Scene>([this](const std::string& scene) {
+    deserialize_scene(scene);
+    m_is_scene_ready = true;
+  });
 
-  EditorEventBus::get().subscribe<const rapidjson::Document&>(
-      EditorEvent::EntityPropertyChanged,
+  bus.subscribe<EditorEvent::EntityPropertyChanged>(
       [this](const rapidjson::Document& doc) {
         handle_entity_property_changed(doc);
       });
 
-  EditorEventBus::get().subscribe<const rapidjson::Document&>(
-      EditorEvent::EntityVariantAdded, [this](const rapidjson::Document& msg) {
+  bus.subscribe<EditorEvent::EntityVariantAdded>(
+      [this](const rapidjson::Document& msg) {
         handle_entity_variant_added(msg);
       });
 
-  EditorEventBus::get().subscribe<const rapidjson::Document&>(
-      EditorEvent::EntityVariantRemoved,
+  bus.subscribe<EditorEvent::EntityVariantRemoved>(
       [this](const rapidjson::Document& msg) {
         handle_entity_variant_removed(msg);
       });
 
-  EditorEventBus::get().subscribe<const rapidjson::Document&>(
-      EditorEvent::EntityRemoved,
+  bus.subscribe<EditorEvent::EntityRemoved>(
       [this](const rapidjson::Document& msg) { handle_entity_removed(msg); });
 
-  EditorEventBus::get().subscribe<bool>(EditorEvent::EnterPlayMode,
-                                        [this](bool is_paused) {
-                                          clean_dead_variants();
-                                          enter_play_mode(is_paused);
-                                        });
+  bus.subscribe<EditorEvent::EnterPlayMode>([this](bool is_paused) {
+    clean_dead_variants();
+    enter_play_mode(is_paused);
+  });
 
-  EditorEventBus::get().subscribe<bool>(EditorEvent::ExitPlayMode,
-                                        [this](bool) { exit_play_mode(); });
+  bus.subscribe<EditorEvent::ExitPlayMode>([this](bool) { exit_play_mode(); });
 
-  EditorEventBus::get().subscribe<bool>(
-      EditorEvent::PausePlayMode,
+  bus.subscribe<EditorEvent::PausePlayMode>(
       [this](bool) { m_is_pause_play_mode = true; });
 
-  EditorEventBus::get().subscribe<bool>(
-      EditorEvent::UnPausePlayMode,
+  bus.subscribe<EditorEvent::UnPausePlayMode>(
       [this](bool) { m_is_pause_play_mode = false; });
 
-  EditorEventBus::get().subscribe<bool>(EditorEvent::Die,
-                                        [this](bool) { m_should_die = true; });
+  bus.subscribe<EditorEvent::Die>([this](bool) { m_should_die = true; });
+
+  bus.subscribe<EditorEvent::SyncAcknowledged>(
+      [this](uint64_t sync_seq) { handle_sync_acknowledged(sync_seq); });
 }
 
 void Zeytin::handle_entity_property_changed(const rapidjson::Document& doc) {
@@ -435,6 +443,8 @@ void Zeytin::handle_entity_property_changed(const rapidjson::Document& doc) {
         update_property(variant, path_parts, 0, value_str);
       }
 
+      // may have moved a static collider
+      PhysicsWorld::get().invalidate_static();
       break;
     }
   }
@@ -521,6 +531,7 @@ void Zeytin::enter_play_mode(bool is_paused) {
 }
 
 void Zeytin::exit_play_mode() {
+  PhysicsWorld::get().clear();  // holds pointers into the storage
   m_storage.clear();
   m_started = false;
   m_is_play_mode = false;
@@ -540,22 +551,42 @@ void Zeytin::exit_play_mode() {
 }
 
 void Zeytin::initial_sync_editor() {
-  std::string scene = serialize_scene();
-  EditorEventBus::get().publish<std::string>(EditorEvent::SyncEditor, scene);
+  publish_sync(serialize_scene(m_sync_seq + 1));
 }
 
 void Zeytin::sync_editor() {
-  static float sync_timer = 0.0f;
-  static const float SYNC_INTERVAL = 0.1f;
+  static constexpr float MIN_SYNC_INTERVAL = 0.05f;
+  static constexpr float MAX_SYNC_INTERVAL = 2.0f;
+  static constexpr float SYNC_ACK_TIMEOUT = 2.0f;
+  static constexpr float SYNC_BYTES_PER_SECOND = 4.0f * 1024.0f * 1024.0f;
 
-  sync_timer += get_frame_time();
+  float elapsed = static_cast<float>(get_time() - m_last_sync_time);
 
-  if (sync_timer >= SYNC_INTERVAL) {
-    sync_timer = 0.0f;
+  // editor has not consumed the previous snapshot yet, do not pile up more
+  bool awaiting_ack = m_acked_sync_seq != m_sync_seq;
+  if (awaiting_ack && elapsed < SYNC_ACK_TIMEOUT) return;
 
-    std::string scene = serialize_scene();
-    EditorEventBus::get().publish<std::string>(EditorEvent::SyncEditor, scene);
-  }
+  if (elapsed < m_sync_interval) return;
+
+  publish_sync(serialize_scene(m_sync_seq + 1));
+
+  float size_interval = m_last_sync_size / SYNC_BYTES_PER_SECOND;
+  m_sync_interval = std::clamp(std::max(size_interval, 2.0f * m_sync_lag),
+                               MIN_SYNC_INTERVAL, MAX_SYNC_INTERVAL);
+}
+
+void Zeytin::publish_sync(std::string scene) {
+  m_sync_seq++;
+  m_last_sync_time = get_time();
+  m_last_sync_size = scene.size();
+  EditorEventBus::get().publish<EditorEvent::SyncEditor>(scene);
+}
+
+void Zeytin::handle_sync_acknowledged(uint64_t sync_seq) {
+  if (sync_seq != m_sync_seq) return;  // stale ack of a timed out snapshot
+
+  m_acked_sync_seq = sync_seq;
+  m_sync_lag = static_cast<float>(get_time() - m_last_sync_time);
 }
 
 void Zeytin::generate_variants() {
@@ -17,18 +17,24 @@ EditorCommunication::EditorCommunication()
     , m_subscriber(m_context, zmq::socket_type::sub) {
 
     initialize();
-    start_connection_attempts();
 
-    EditorEventBus::get().subscribe<std::string>(EditorEvent::SyncEditor, [this](std::string json) {
+    m_subscriptions.push_back(EditorEventBus::get().subscribe<EditorEvent::EngineStartConfirmed>([this](bool) {
+            m_connection_confirmed = true;
+    }));
+
+    m_subscriptions.push_back(EditorEventBus::get().subscribe<EditorEvent::SyncEditor>([this](const std::string& json) {
             send_message(json);
-    });
+    }));
 
-    EditorEventBus::get().subscribe<const std::string&>(EditorEvent::LogToEditor, [this](const auto& json) {
+    m_subscriptions.push_back(EditorEventBus::get().subscribe<EditorEvent::LogToEditor>([this](const std::string& json) {
             send_message(json);
-    });
+    }));
 }
 
 EditorCommunication::~EditorCommunication() {
+    for (auto& subscription : m_subscriptions) {
+        subscription.unsubscribe();
+    }
     shutdown();
 }
 
@@ -42,6 +48,10 @@ bool EditorCommunication::initialize() {
 
         m_subscriber.set(zmq::sockopt::subscribe, "");
 
+        // don't block process exit on messages the editor never picks up
+        m_publisher.set(zmq::sockopt::linger, 1000);
+        m_subscriber.set(zmq::sockopt::linger, 0);
+
         m_running = true;
         m_receive_thread = std::thread(&EditorCommunication::receive_messages, this);
 
@@ -55,28 +65,28 @@ bool EditorCommunication::initialize() {
     }
 }
 
-void EditorCommunication::start_connection_attempts() {
-    std::thread([this]() {
-        EditorEventBus::get().subscribe<bool>(EditorEvent::EngineStartConfirmed,
-            [this](bool) {
-                m_connection_confirmed = true;
-            });
+void EditorCommunication::attempt_connection() {
+    static constexpr int max_attempts = 30;
+    static constexpr auto attempt_interval = std::chrono::milliseconds(1000);
 
-        int attempts = 0;
-        const int max_attempts = 30;
+    if (m_connection_confirmed || m_connection_attempts > max_attempts) {
+        return;
+    }
 
-        while (m_running && !m_connection_confirmed && attempts < max_attempts) {
-            send_started_message();
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            attempts++;
-        }
+    auto now = std::chrono::steady_clock::now();
+    if (m_connection_attempts > 0 && now - m_last_connection_attempt < attempt_interval) {
+        return;
+    }
 
-        if (m_connection_confirmed) {
-            log_info() << "Connection to editor confirmed!" << std::endl;
-        } else if (attempts >= max_attempts) {
-            log_error() << "Failed to connect to editor after " << max_attempts << " attempts" << std::endl;
-        }
-    }).detach();
+    if (m_connection_attempts == max_attempts) {
+        log_error() << "Failed to connect to editor after " << max_attempts << " attempts" << std::endl;
+        m_connection_attempts++;
+        return;
+    }
+
+    send_started_message();
+    m_last_connection_attempt = now;
+    m_connection_attempts++;
 }
 
 void EditorCommunication::send_started_message() {
@@ -140,62 +150,78 @@ bool EditorCommunication::send_message(const std::string& message) {
 }
 
 void EditorCommunication::raise_events() {
-    while (!m_message_queue.empty()) {
-        const auto& msg = m_message_queue.front();
+    attempt_connection();
+
+    std::queue<std::string> messages;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        messages.swap(m_message_queue);
+    }
+
+    while (!messages.empty()) {
+        const auto& msg = messages.front();
         rapidjson::Document doc;
         doc.Parse(msg.c_str());
         
         if (doc.HasParseError() || !doc.HasMember("type")) {
             log_warning() << "Invalid message format received" << std::endl;
-            m_message_queue.pop();
+            messages.pop();
             continue;
         }
         
         const std::string& type = doc["type"].GetString();
         
         if (type == "entity_property_changed") {
-            EditorEventBus::get().publish<const rapidjson::Document&>(EditorEvent::EntityPropertyChanged, doc);
+            EditorEventBus::get().publish<EditorEvent::EntityPropertyChanged>(doc);
         }
         else if (type == "entity_variant_added") {
-            EditorEventBus::get().publish<const rapidjson::Document&>(EditorEvent::EntityVariantAdded, doc);
+            EditorEventBus::get().publish<EditorEvent::EntityVariantAdded>(doc);
         }
         else if (type == "entity_variant_removed") {
-            EditorEventBus::get().publish<const rapidjson::Document&>(EditorEvent::EntityVariantRemoved, doc);
+            EditorEventBus::get().publish<EditorEvent::EntityVariantRemoved>(doc);
         }
         else if (type == "entity_removed") {
-            EditorEventBus::get().publish<const rapidjson::Document&>(EditorEvent::EntityRemoved, doc);
+            EditorEventBus::get().publish<EditorEvent::EntityRemoved>(doc);
         }
         else if (type == "enter_play_mode") {
             bool is_paused = doc["is_paused"].GetBool();
-            EditorEventBus::get().publish<bool>(EditorEvent::EnterPlayMode, is_paused);
+            EditorEventBus::get().publish<EditorEvent::EnterPlayMode>(is_paused);
         }
         else if (type == "exit_play_mode") {
-            EditorEventBus::get().publish<bool>(EditorEvent::ExitPlayMode, false);
+            EditorEventBus::get().publish<EditorEvent::ExitPlayMode>(false);
         }
         else if (type == "pause_play_mode") {
-            EditorEventBus::get().publish<bool>(EditorEvent::PausePlayMode, true);
+            EditorEventBus::get().publish<EditorEvent::PausePlayMode>(true);
         }
         else if (type == "unpause_play_mode") {
-            EditorEventBus::get().publish<bool>(EditorEvent::UnPausePlayMode, true);
+            EditorEventBus::get().publish<EditorEvent::UnPausePlayMode>(true);
         }
         else if (type == "engine_start_confirmed") {
-            EditorEventBus::get().publish<bool>(EditorEvent::EngineStartConfirmed, true);
+            if (!m_connection_confirmed) {
+                log_info() << "Connection to editor confirmed!" << std::endl;
+            }
+            EditorEventBus::get().publish<EditorEvent::EngineStartConfirmed>(true);
         }
         else if (type == "scene") {
             std::cout << "Scene is received" << std::endl;
-            EditorEventBus::get().publish<const std::string&>(EditorEvent::Scene, msg);
+            EditorEventBus::get().publish<EditorEvent::Scene>(msg);
         }
         else if(type == "die") {
-            EditorEventBus::get().publish<bool>(EditorEvent::Die, true);
+            EditorEventBus::get().publish<EditorEvent::Die>(true);
+        }
+        else if(type == "sync_ack") {
+            if (doc.HasMember("sync_seq") && doc["sync_seq"].IsUint64()) {
+                EditorEventBus::get().publish<EditorEvent::SyncAcknowledged>(doc["sync_seq"].GetUint64());
+            }
         }
         else if(type == "window_state") {
-            EditorEventBus::get().publish<const rapidjson::Document&>(EditorEvent::WindowStateChanged, doc);
+            EditorEventBus::get().publish<EditorEvent::WindowStateChanged>(doc);
         }
         else {
             log_warning() << "Unknown message type received from editor" << std::endl;
         }
         
-        m_message_queue.pop();
+        messages.pop();
     }
 }
 
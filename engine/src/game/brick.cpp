@@ -1,7 +1,9 @@
 #include "game/brick.h"
+#include <cstdio>
 #include "core/query.h"
 #include "core/raylib_wrapper.h"
 #include "game/game.h"
+#include "render/render_queue.h"
 
 void Brick::on_play_update() {
   if (is_destroyed()) {
@@ -14,12 +16,17 @@ void Brick::on_play_update() {
                     position.y - collider.m_height / 2, collider.m_width,
                     collider.m_height};
 
-  draw_rectangle_rec(rect, m_color);
-  draw_rectangle_lines_ex(rect, 2.0f, BLACK);
-
-  char health_text[2];
-  printf(health_text, "%d", m_health);
-  draw_text(health_text, position.x - 5, position.y - 10, 20, WHITE);
+  // redrawn only when a brick is hit or destroyed
+  RenderQueue::StaticScope static_scope;
+  auto& queue = RenderQueue::get();
+  queue.draw_rectangle(rect, m_color);
+  queue.draw_rectangle_lines(rect, 2.0f, BLACK);
+
+  // the queue lays a label out once per text, not once per brick
+  char health_text[12];
+  snprintf(health_text, sizeof(health_text), "%d", m_health);
+  queue.draw_text(health_text, Vector2{position.x - 5, position.y - 10}, 20,
+                  WHITE);
 }
 
 void Brick::damage() {
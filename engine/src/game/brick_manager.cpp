@@ -8,12 +8,12 @@ void BrickManager::on_play_start() {
     auto result = Query::try_find_first<Game>();
     if(result) {
         auto& game = result->get();
-        game.register_on_game_end([this] {
+        m_connections.add(game.register_on_game_end([this] {
             Query::for_each<Brick>([this](Brick& brick){
                 // rebuild it, just the way it was, brick by brick
                 brick.reset();
             });
-        });
+        }));
     }
 }
 
@@ -38,6 +38,8 @@ void BrickManager::create_brick(float x, float y, int row, int col) {
     collider.m_collider_type = 1; 
     collider.m_width = brick_width;
     collider.m_height = brick_height;
+    collider.m_category = 1 << 1;  // bricks layer, see physics_layer_1_mask
+    collider.m_static = true;  // never moves, lives in the static tree
 }
 
 Color BrickManager::get_brick_color(int row) const {
@@ -2,7 +2,8 @@
 #include "game/position.h"
 
 #include "core/query.h"
-#include "raymath.h"
+#include "physics/narrow_phase.h"
+#include "render/render_queue.h"
 
 enum class ColliderType : int {
     None = 0,
@@ -14,71 +15,8 @@ void Collider::on_update() {
     debug_draw();
 }
 
-void Collider::on_play_update() {
-    check_collisions();
-}
-
-void Collider::check_collisions() {
-    auto& position = Query::read<Position>(this);
-
-    Query::for_each<Collider>([this](Collider& other) {
-        if(!m_enable || !other.m_enable) {
-            return;
-        }
-
-        if (other.entity_id == entity_id) {
-            return;
-        }
-
-        if (other.m_collider_type == (int)ColliderType::None) {
-            return;
-        }
-
-        if (this->intersects(other)) {
-            if(m_callback) {
-                m_callback(other);
-            }
-        }
-    });
-}
-
 bool Collider::intersects(const Collider& other) const {
-    if (m_collider_type == 0 || other.m_collider_type == 0) {
-        return false;
-    }
-
-    if (m_collider_type == 1 && other.m_collider_type == 1) {
-        const auto& this_rect = get_rectangle();
-        const auto& other_rect = other.get_rectangle();
-        return CheckCollisionRecs(this_rect, other_rect);
-    }
-
-    if (m_collider_type == 2 && other.m_collider_type == 2) {
-        Vector2 center1 = get_circle_center();
-        Vector2 center2 = other.get_circle_center();
-        float distance = Vector2Distance(center1, center2);
-        return distance <= (m_radius + other.m_radius);
-    }
-
-    if ((m_collider_type == 1 && other.m_collider_type == 2) ||
-        (m_collider_type == 2 && other.m_collider_type == 1)) {
-
-        const Collider& rect_collider = (m_collider_type == 1) ? *this : other;
-        const Collider& circle_collider = (m_collider_type == 2) ? *this : other;
-
-        Rectangle rect = rect_collider.get_rectangle();
-        Vector2 center = circle_collider.get_circle_center();
-        float radius = circle_collider.m_radius;
-
-        float closest_x = fmaxf(rect.x, fminf(center.x, rect.x + rect.width));
-        float closest_y = fmaxf(rect.y, fminf(center.y, rect.y + rect.height));
-
-        float distance = Vector2Distance(center, {closest_x, closest_y});
-
-        return distance <= radius;
-    }
-
-    return false;
+    return NarrowPhase::overlaps(get_shape(), other.get_shape());
 }
 
 Rectangle Collider::get_rectangle() const {
@@ -101,6 +39,19 @@ Vector2 Collider::get_circle_center() const {
     };
 }
 
+CollisionShape Collider::get_shape() const {
+    const auto& position = Query::get<Position>(this);
+
+    CollisionShape shape;
+    shape.type = m_collider_type;
+    shape.x = position.x;
+    shape.y = position.y;
+    shape.half_width = m_width / 2;
+    shape.half_height = m_height / 2;
+    shape.radius = m_radius;
+    return shape;
+}
+
 void Collider::debug_draw() {
     if (!m_draw_debug) {
         return;
@@ -111,14 +62,15 @@ void Collider::debug_draw() {
 
     switch (m_collider_type) {
         case (int)ColliderType::Rectangle:
-            DrawRectangleLinesEx(get_rectangle(), 3, color);
+            RenderQueue::get().draw_rectangle_lines(
+                get_rectangle(), 3, color, RenderQueue::k_top_layer);
             break;
         case (int)ColliderType::Circle:
-            DrawCircleLines(
-                position.x, 
-                position.y, 
-                m_radius, 
-                color
+            RenderQueue::get().draw_circle_lines(
+                Vector2{position.x, position.y},
+                m_radius,
+                color,
+                RenderQueue::k_top_layer
             );
             break;
         default:
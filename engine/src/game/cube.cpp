@@ -2,6 +2,7 @@
 #include "game/speed.h"
 #include "core/query.h"
 #include "core/raylib_wrapper.h"
+#include "render/render_queue.h"
 
 #include "remote_logger/remote_logger.h"
 
@@ -13,11 +14,9 @@ void Cube::on_init() {
 void Cube::on_update() {
     if (auto position_opt = Query::try_get<Position>(entity_id)) {
         const auto& position = position_opt->get();
-        draw_rectangle(
-            position.x - width / 2,
-            position.y - height / 2,
-            width,
-            height,
+        RenderQueue::get().draw_rectangle(
+            Rectangle{position.x - width / 2, position.y - height / 2, width,
+                      height},
             color);
     }
 }
@@ -12,12 +12,7 @@ void Game::on_play_update() {
 void Game::start_game() {
     if (m_game_state != GameState::Running) {
         m_game_state = GameState::Running;
-        
-        for (const auto& callback : m_game_start_callbacks) {
-            if (callback) {
-                callback();
-            }
-        }
+        m_on_game_start.emit();
         
         log_info() << "Game started" << std::endl;
     } else {
@@ -28,12 +23,7 @@ void Game::start_game() {
 void Game::end_game() {
     if (m_game_state != GameState::End) {
         m_game_state = GameState::End;
-        
-        for (const auto& callback : m_game_end_callbacks) {
-            if (callback) {
-                callback();
-            }
-        }
+        m_on_game_end.emit();
         
         log_info() << "Game ended" << std::endl;
     } else {
@@ -41,30 +31,20 @@ void Game::end_game() {
     }
 }
 
-void Game::register_on_game_start(callback cb) {
-    if (cb) {
-        m_game_start_callbacks.push_back(cb);
-    }
+Connection Game::register_on_game_start(Signal<>::Slot cb) {
+    return m_on_game_start.connect(std::move(cb));
 }
 
-void Game::register_on_game_end(callback cb) {
-    if (cb) {
-        m_game_end_callbacks.push_back(cb);
-    }
+Connection Game::register_on_game_end(Signal<>::Slot cb) {
+    return m_on_game_end.connect(std::move(cb));
 }
 
-void Game::register_on_brick_destoryed(std::function<void(const Brick& brick)> cb) {
-    if (cb) {
-        m_on_brick_destroyed.push_back(cb);
-    }
+Connection Game::register_on_brick_destoryed(Signal<const Brick&>::Slot cb) {
+    return m_on_brick_destroyed.connect(std::move(cb));
 }
 
 void Game::on_break_destroyed(const Brick& brick) {
-    for(const auto& callback : m_on_brick_destroyed) {
-        if(callback) {
-            callback(brick);
-        }
-    }
+    m_on_brick_destroyed.emit(brick);
 }
 
 
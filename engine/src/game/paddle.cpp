@@ -2,17 +2,16 @@
 #include "game/position.h"
 #include "core/query.h"
 #include "core/raylib_wrapper.h"
+#include "render/render_queue.h"
 
 void Paddle::on_init() {}
 
 void Paddle::on_update() {
     auto& position = Query::get<Position>(this);
     
-    draw_rectangle(
-        position.x - width / 2,
-        position.y - height / 2,
-        width,
-        height,
+    RenderQueue::get().draw_rectangle(
+        Rectangle{position.x - width / 2, position.y - height / 2, width,
+                  height},
         BLUE);
 }
 
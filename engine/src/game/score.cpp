@@ -1,15 +1,16 @@
 #include "game/score.h"
-#include <xlocale/_stdio.h>
+#include <cstdio>
 #include "core/query.h"
 #include "core/raylib_wrapper.h"
 #include "game/game.h"
+#include "render/render_queue.h"
 
 void Score::on_play_start() {
   auto& game = Query::find_first<Game>();
-  game.register_on_brick_destoryed(
-      [this](const auto& brick) { on_break_destroyed(brick); });
+  m_connections.add(game.register_on_brick_destoryed(
+      [this](const Brick& brick) { on_break_destroyed(brick); }));
 
-  game.register_on_game_start([this]() { reset(); });
+  m_connections.add(game.register_on_game_start([this]() { reset(); }));
 }
 
 void Score::add_points(int points) { value += points; }
@@ -18,6 +19,6 @@ void Score::reset() { value = 0; }
 
 void Score::on_update() {
   char score_text[32];
-  printf(score_text, "SCORE: %d", (int)value);
-  draw_text(score_text, x, y, font_size, PURPLE);
+  snprintf(score_text, sizeof(score_text), "SCORE: %d", (int)value);
+  RenderQueue::get().draw_text(score_text, Vector2{x, y}, font_size, PURPLE);
 }
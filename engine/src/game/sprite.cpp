@@ -3,11 +3,11 @@
 
 #include "raylib.h"
 #include "core/query.h"
+#include "render/render_queue.h"
 
 void Sprite::on_init() {
     if(!path_to_sprite.empty()) {
-        this->texture = LoadTexture(path_to_sprite.c_str()); 
-        m_texture_loaded = true;
+        m_texture_loaded = SpriteBatch::get().load(path_to_sprite, m_frame);
     }
 }
 
@@ -16,23 +16,28 @@ void Sprite::on_update() {
 
     const auto [position, scale] = Query::read<Position, Scale>(this);
 
-    float width = texture.width * scale.x;
-    float height = texture.height * scale.y;
+    RenderQueue::StaticScope static_scope(is_static);
 
-    DrawTexturePro(
-        texture,
-        Rectangle{ 0, 0, (float)texture.width, (float)texture.height },  
+    float width = m_frame.source.width * scale.x;
+    float height = m_frame.source.height * scale.y;
+
+    RenderQueue::get().draw_texture(
+        m_frame,
         Rectangle{ position.x, position.y, width, height },  
         Vector2{ width/2, height/2 },  
         0.0f,  
-        WHITE   
+        WHITE,
+        layer
     );
 }
 
 void Sprite::handle_new_path() {
+    // the old texture goes back to the cache with the old frame
+    m_frame = SpriteFrame();
+    m_texture_loaded = false;
+
     if(!path_to_sprite.empty()) {
-        texture = LoadTexture(path_to_sprite.c_str());
-        m_texture_loaded = true;
+        m_texture_loaded = SpriteBatch::get().load(path_to_sprite, m_frame);
     }
 
     log_info() << "Handle new path" << std::endl;
@@ -0,0 +1,336 @@
+#include "physics/aabb_tree.h"
+#include <algorithm>
+
+int32_t AabbTree::create_proxy(const Aabb& bounds, uint32_t user_data,
+                               float margin) {
+  int32_t proxy = allocate_node();
+  Node& node = m_nodes[proxy];
+  node.bounds = bounds.expanded(margin);
+  node.user_data = user_data;
+  node.height = 0;
+
+  insert_leaf(proxy);
+  m_proxy_count++;
+  return proxy;
+}
+
+void AabbTree::destroy_proxy(int32_t proxy) {
+  remove_leaf(proxy);
+  free_node(proxy);
+  m_proxy_count--;
+}
+
+bool AabbTree::move_proxy(int32_t proxy, const Aabb& bounds, float margin) {
+  const Aabb& fat = m_nodes[proxy].bounds;
+
+  // a proxy that shrank a lot gets tighter bounds as well
+  if (fat.contains(bounds) && bounds.expanded(4.0f * margin).contains(fat)) {
+    return false;
+  }
+
+  remove_leaf(proxy);
+  m_nodes[proxy].bounds = bounds.expanded(margin);
+  insert_leaf(proxy);
+  return true;
+}
+
+void AabbTree::rebuild() {
+  m_leaves.clear();
+
+  for (int32_t i = 0; i < (int32_t)m_nodes.size(); i++) {
+    Node& node = m_nodes[i];
+    if (node.height < 0) continue;
+
+    if (node.is_leaf()) {
+      node.parent = k_null;
+      m_leaves.push_back(i);
+    } else {
+      free_node(i);
+    }
+  }
+
+  m_root = m_leaves.empty() ? k_null
+                            : build_top_down(m_leaves.data(), m_leaves.size());
+}
+
+void AabbTree::clear() {
+  m_nodes.clear();
+  m_root = k_null;
+  m_free_list = k_null;
+  m_proxy_count = 0;
+}
+
+int32_t AabbTree::allocate_node() {
+  if (m_free_list == k_null) {
+    m_nodes.emplace_back();
+    return (int32_t)m_nodes.size() - 1;
+  }
+
+  int32_t node = m_free_list;
+  m_free_list = m_nodes[node].parent;
+  m_nodes[node] = Node();
+  return node;
+}
+
+void AabbTree::free_node(int32_t node) {
+  m_nodes[node].parent = m_free_list;
+  m_nodes[node].child1 = k_null;
+  m_nodes[node].child2 = k_null;
+  m_nodes[node].height = -1;
+  m_free_list = node;
+}
+
+void AabbTree::insert_leaf(int32_t leaf) {
+  if (m_root == k_null) {
+    m_root = leaf;
+    m_nodes[leaf].parent = k_null;
+    return;
+  }
+
+  // walk down to the cheapest sibling by the surface area heuristic
+  Aabb leaf_bounds = m_nodes[leaf].bounds;
+  int32_t index = m_root;
+
+  while (!m_nodes[index].is_leaf()) {
+    const Node& node = m_nodes[index];
+
+    float area = node.bounds.perimeter();
+    float combined_area = node.bounds.merged(leaf_bounds).perimeter();
+
+    // cost of pairing the leaf with this node
+    float cost = 2.0f * combined_area;
+    // cost pushed down to the children if we descend
+    float inheritance_cost = 2.0f * (combined_area - area);
+
+    auto child_cost = [&](int32_t child) {
+      const Node& c = m_nodes[child];
+      float merged = c.bounds.merged(leaf_bounds).perimeter();
+      if (c.is_leaf()) return merged + inheritance_cost;
+      return merged - c.bounds.perimeter() + inheritance_cost;
+    };
+
+    float cost1 = child_cost(node.child1);
+    float cost2 = child_cost(node.child2);
+
+    if (cost < cost1 && cost < cost2) break;
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  int32_t sibling = index;
+  int32_t old_parent = m_nodes[sibling].parent;
+  int32_t new_parent = allocate_node();
+
+  Node& parent = m_nodes[new_parent];
+  parent.parent = old_parent;
+  parent.bounds = leaf_bounds.merged(m_nodes[sibling].bounds);
+  parent.height = m_nodes[sibling].height + 1;
+  parent.child1 = sibling;
+  parent.child2 = leaf;
+
+  if (old_parent != k_null) {
+    Node& grand_parent = m_nodes[old_parent];
+    if (grand_parent.child1 == sibling) {
+      grand_parent.child1 = new_parent;
+    } else {
+      grand_parent.child2 = new_parent;
+    }
+  } else {
+    m_root = new_parent;
+  }
+
+  m_nodes[sibling].parent = new_parent;
+  m_nodes[leaf].parent = new_parent;
+
+  refit_upwards(m_nodes[leaf].parent);
+}
+
+void AabbTree::remove_leaf(int32_t leaf) {
+  if (leaf == m_root) {
+    m_root = k_null;
+    return;
+  }
+
+  int32_t parent = m_nodes[leaf].parent;
+  int32_t grand_parent = m_nodes[parent].parent;
+  int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2
+                                                   : m_nodes[parent].child1;
+
+  if (grand_parent != k_null) {
+    // the sibling takes the place of the parent
+    Node& node = m_nodes[grand_parent];
+    if (node.child1 == parent) {
+      node.child1 = sibling;
+    } else {
+      node.child2 = sibling;
+    }
+    m_nodes[sibling].parent = grand_parent;
+    free_node(parent);
+
+    refit_upwards(grand_parent);
+  } else {
+    m_root = sibling;
+    m_nodes[sibling].parent = k_null;
+    free_node(parent);
+  }
+
+  m_nodes[leaf].parent = k_null;
+}
+
+void AabbTree::refit_upwards(int32_t index) {
+  while (index != k_null) {
+    index = balance(index);
+
+    Node& node = m_nodes[index];
+    const Node& child1 = m_nodes[node.child1];
+    const Node& child2 = m_nodes[node.child2];
+
+    node.height = 1 + std::max(child1.height, child2.height);
+    node.bounds = child1.bounds.merged(child2.bounds);
+
+    index = node.parent;
+  }
+}
+
+// rotates the taller grandchild up when the children of a differ in height by
+// more than one, returns the index of the new subtree root
+int32_t AabbTree::balance(int32_t a_index) {
+  Node& a = m_nodes[a_index];
+  if (a.is_leaf() || a.height < 2) return a_index;
+
+  int32_t b_index = a.child1;
+  int32_t c_index = a.child2;
+  Node& b = m_nodes[b_index];
+  Node& c = m_nodes[c_index];
+
+  int32_t balance = c.height - b.height;
+
+  // rotate c up
+  if (balance > 1) {
+    int32_t f_index = c.child1;
+    int32_t g_index = c.child2;
+    Node& f = m_nodes[f_index];
+    Node& g = m_nodes[g_index];
+
+    c.child1 = a_index;
+    c.parent = a.parent;
+    a.parent = c_index;
+
+    if (c.parent != k_null) {
+      Node& parent = m_nodes[c.parent];
+      if (parent.child1 == a_index) {
+        parent.child1 = c_index;
+      } else {
+        parent.child2 = c_index;
+      }
+    } else {
+      m_root = c_index;
+    }
+
+    if (f.height > g.height) {
+      c.child2 = f_index;
+      a.child2 = g_index;
+      g.parent = a_index;
+      a.bounds = b.bounds.merged(g.bounds);
+      c.bounds = a.bounds.merged(f.bounds);
+      a.height = 1 + std::max(b.height, g.height);
+      c.height = 1 + std::max(a.height, f.height);
+    } else {
+      c.child2 = g_index;
+      a.child2 = f_index;
+      f.parent = a_index;
+      a.bounds = b.bounds.merged(f.bounds);
+      c.bounds = a.bounds.merged(g.bounds);
+      a.height = 1 + std::max(b.height, f.height);
+      c.height = 1 + std::max(a.height, g.height);
+    }
+
+    return c_index;
+  }
+
+  // rotate b up
+  if (balance < -1) {
+    int32_t d_index = b.child1;
+    int32_t e_index = b.child2;
+    Node& d = m_nodes[d_index];
+    Node& e = m_nodes[e_index];
+
+    b.child1 = a_index;
+    b.parent = a.parent;
+    a.parent = b_index;
+
+    if (b.parent != k_null) {
+      Node& parent = m_nodes[b.parent];
+      if (parent.child1 == a_index) {
+        parent.child1 = b_index;
+      } else {
+        parent.child2 = b_index;
+      }
+    } else {
+      m_root = b_index;
+    }
+
+    if (d.height > e.height) {
+      b.child2 = d_index;
+      a.child1 = e_index;
+      e.parent = a_index;
+      a.bounds = c.bounds.merged(e.bounds);
+      b.bounds = a.bounds.merged(d.bounds);
+      a.height = 1 + std::max(c.height, e.height);
+      b.height = 1 + std::max(a.height, d.height);
+    } else {
+      b.child2 = e_index;
+      a.child1 = d_index;
+      d.parent = a_index;
+      a.bounds = c.bounds.merged(d.bounds);
+      b.bounds = a.bounds.merged(e.bounds);
+      a.height = 1 + std::max(c.height, d.height);
+      b.height = 1 + std::max(a.height, e.height);
+    }
+
+    return b_index;
+  }
+
+  return a_index;
+}
+
+// median split along the longest axis of the leaf centers
+int32_t AabbTree::build_top_down(int32_t* leaves, size_t count) {
+  if (count == 1) return leaves[0];
+
+  auto center = [&](int32_t leaf) {
+    const Aabb& bounds = m_nodes[leaf].bounds;
+    float x = (bounds.min_x + bounds.max_x) * 0.5f;
+    float y = (bounds.min_y + bounds.max_y) * 0.5f;
+    return Aabb{x, y, x, y};
+  };
+
+  Aabb centers = center(leaves[0]);
+  for (size_t i = 1; i < count; i++) {
+    centers = centers.merged(center(leaves[i]));
+  }
+
+  bool split_x = centers.width() >= centers.height();
+  size_t half = count / 2;
+  std::nth_element(leaves, leaves + half, leaves + count,
+                   [&](int32_t lhs, int32_t rhs) {
+                     const Aabb& l = m_nodes[lhs].bounds;
+                     const Aabb& r = m_nodes[rhs].bounds;
+                     return split_x ? l.min_x + l.max_x < r.min_x + r.max_x
+                                    : l.min_y + l.max_y < r.min_y + r.max_y;
+                   });
+
+  int32_t child1 = build_top_down(leaves, half);
+  int32_t child2 = build_top_down(leaves + half, count - half);
+
+  // allocating may grow the node array, so only index into it from here on
+  int32_t index = allocate_node();
+  m_nodes[index].child1 = child1;
+  m_nodes[index].child2 = child2;
+  m_nodes[index].bounds =
+      m_nodes[child1].bounds.merged(m_nodes[child2].bounds);
+  m_nodes[index].height =
+      1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+  m_nodes[child1].parent = index;
+  m_nodes[child2].parent = index;
+  return index;
+}
@@ -0,0 +1,246 @@
+#include "physics/narrow_phase.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZPHYSICS_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ZPHYSICS_NEON
+#endif
+
+namespace {
+
+#if defined(ZPHYSICS_SSE2)
+
+// four lane float helpers, the kernels below are written once against these
+
+using f4 = __m128;
+using m4 = __m128;
+
+inline f4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline f4 add4(f4 a, f4 b) { return _mm_add_ps(a, b); }
+inline f4 sub4(f4 a, f4 b) { return _mm_sub_ps(a, b); }
+inline f4 mul4(f4 a, f4 b) { return _mm_mul_ps(a, b); }
+inline f4 min4(f4 a, f4 b) { return _mm_min_ps(a, b); }
+inline f4 max4(f4 a, f4 b) { return _mm_max_ps(a, b); }
+inline f4 neg4(f4 a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+inline f4 abs4(f4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline m4 less4(f4 a, f4 b) { return _mm_cmplt_ps(a, b); }
+inline m4 less_equal4(f4 a, f4 b) { return _mm_cmple_ps(a, b); }
+inline m4 and4(m4 a, m4 b) { return _mm_and_ps(a, b); }
+inline int mask_bits(m4 mask) { return _mm_movemask_ps(mask); }
+
+#elif defined(ZPHYSICS_NEON)
+
+// the same helpers for arm64 and armv7 with neon
+using f4 = float32x4_t;
+using m4 = uint32x4_t;
+
+inline f4 load4(const float* p) { return vld1q_f32(p); }
+inline f4 add4(f4 a, f4 b) { return vaddq_f32(a, b); }
+inline f4 sub4(f4 a, f4 b) { return vsubq_f32(a, b); }
+inline f4 mul4(f4 a, f4 b) { return vmulq_f32(a, b); }
+inline f4 min4(f4 a, f4 b) { return vminq_f32(a, b); }
+inline f4 max4(f4 a, f4 b) { return vmaxq_f32(a, b); }
+inline f4 neg4(f4 a) { return vnegq_f32(a); }
+inline f4 abs4(f4 a) { return vabsq_f32(a); }
+inline m4 less4(f4 a, f4 b) { return vcltq_f32(a, b); }
+inline m4 less_equal4(f4 a, f4 b) { return vcleq_f32(a, b); }
+inline m4 and4(m4 a, m4 b) { return vandq_u32(a, b); }
+inline int mask_bits(m4 mask) {
+  static const uint32_t k_lane_bits[4] = {1, 2, 4, 8};
+  uint32x4_t bits = vandq_u32(mask, vld1q_u32(k_lane_bits));
+#if defined(__aarch64__) || defined(_M_ARM64)
+  return (int)vaddvq_u32(bits);
+#else
+  // no across vector add before armv8, two pairwise ones instead
+  uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+  return (int)vget_lane_u32(vpadd_u32(sum, sum), 0);
+#endif
+}
+
+#endif
+
+#if defined(ZPHYSICS_SSE2) || defined(ZPHYSICS_NEON)
+constexpr size_t k_lanes = 4;
+
+inline void append_hits(int mask, const uint32_t* pairs,
+                        std::vector<uint32_t>& overlapping) {
+  for (int lane = 0; mask; lane++, mask >>= 1) {
+    if (mask & 1) overlapping.push_back(pairs[lane]);
+  }
+}
+#endif
+
+inline bool rect_rect(float dx, float dy, float sum_half_width,
+                      float sum_half_height) {
+  // strict like CheckCollisionRecs, touching edges don't overlap
+  return std::fabs(dx) < sum_half_width && std::fabs(dy) < sum_half_height;
+}
+
+inline bool circle_circle(float dx, float dy, float sum_radius) {
+  return dx * dx + dy * dy <= sum_radius * sum_radius;
+}
+
+inline bool rect_circle(float dx, float dy, float half_width,
+                        float half_height, float radius) {
+  float ex = dx - std::clamp(dx, -half_width, half_width);
+  float ey = dy - std::clamp(dy, -half_height, half_height);
+  return ex * ex + ey * ey <= radius * radius;
+}
+
+}  // namespace
+
+void NarrowPhase::clear() {
+  m_rect_rect.dx.clear();
+  m_rect_rect.dy.clear();
+  m_rect_rect.sum_half_width.clear();
+  m_rect_rect.sum_half_height.clear();
+  m_rect_rect.pair.clear();
+
+  m_circle_circle.dx.clear();
+  m_circle_circle.dy.clear();
+  m_circle_circle.sum_radius.clear();
+  m_circle_circle.pair.clear();
+
+  m_rect_circle.dx.clear();
+  m_rect_circle.dy.clear();
+  m_rect_circle.half_width.clear();
+  m_rect_circle.half_height.clear();
+  m_rect_circle.radius.clear();
+  m_rect_circle.pair.clear();
+}
+
+void NarrowPhase::add(uint32_t pair, const CollisionShape& a,
+                      const CollisionShape& b) {
+  if (a.type == CollisionShape::Rectangle &&
+      b.type == CollisionShape::Rectangle) {
+    m_rect_rect.dx.push_back(a.x - b.x);
+    m_rect_rect.dy.push_back(a.y - b.y);
+    m_rect_rect.sum_half_width.push_back(a.half_width + b.half_width);
+    m_rect_rect.sum_half_height.push_back(a.half_height + b.half_height);
+    m_rect_rect.pair.push_back(pair);
+  } else if (a.type == CollisionShape::Circle &&
+             b.type == CollisionShape::Circle) {
+    m_circle_circle.dx.push_back(a.x - b.x);
+    m_circle_circle.dy.push_back(a.y - b.y);
+    m_circle_circle.sum_radius.push_back(a.radius + b.radius);
+    m_circle_circle.pair.push_back(pair);
+  } else if (a.type != CollisionShape::None &&
+             b.type != CollisionShape::None) {
+    const CollisionShape& rect = a.type == CollisionShape::Rectangle ? a : b;
+    const CollisionShape& circle = a.type == CollisionShape::Circle ? a : b;
+    m_rect_circle.dx.push_back(circle.x - rect.x);
+    m_rect_circle.dy.push_back(circle.y - rect.y);
+    m_rect_circle.half_width.push_back(rect.half_width);
+    m_rect_circle.half_height.push_back(rect.half_height);
+    m_rect_circle.radius.push_back(circle.radius);
+    m_rect_circle.pair.push_back(pair);
+  }
+}
+
+void NarrowPhase::run(std::vector<uint32_t>& overlapping) const {
+  run_rect_rect(overlapping);
+  run_circle_circle(overlapping);
+  run_rect_circle(overlapping);
+}
+
+bool NarrowPhase::overlaps(const CollisionShape& a, const CollisionShape& b) {
+  if (a.type == CollisionShape::None || b.type == CollisionShape::None) {
+    return false;
+  }
+
+  if (a.type == CollisionShape::Rectangle &&
+      b.type == CollisionShape::Rectangle) {
+    return rect_rect(a.x - b.x, a.y - b.y, a.half_width + b.half_width,
+                     a.half_height + b.half_height);
+  }
+
+  if (a.type == CollisionShape::Circle && b.type == CollisionShape::Circle) {
+    return circle_circle(a.x - b.x, a.y - b.y, a.radius + b.radius);
+  }
+
+  const CollisionShape& rect = a.type == CollisionShape::Rectangle ? a : b;
+  const CollisionShape& circle = a.type == CollisionShape::Circle ? a : b;
+  return rect_circle(circle.x - rect.x, circle.y - rect.y, rect.half_width,
+                     rect.half_height, circle.radius);
+}
+
+void NarrowPhase::run_rect_rect(std::vector<uint32_t>& overlapping) const {
+  const RectRectBatch& batch = m_rect_rect;
+  size_t count = batch.pair.size();
+  size_t i = 0;
+
+#if defined(ZPHYSICS_SSE2) || defined(ZPHYSICS_NEON)
+  for (; i + k_lanes <= count; i += k_lanes) {
+    f4 dx = abs4(load4(&batch.dx[i]));
+    f4 dy = abs4(load4(&batch.dy[i]));
+    m4 x = less4(dx, load4(&batch.sum_half_width[i]));
+    m4 y = less4(dy, load4(&batch.sum_half_height[i]));
+    append_hits(mask_bits(and4(x, y)), &batch.pair[i], overlapping);
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (rect_rect(batch.dx[i], batch.dy[i], batch.sum_half_width[i],
+                  batch.sum_half_height[i])) {
+      overlapping.push_back(batch.pair[i]);
+    }
+  }
+}
+
+void NarrowPhase::run_circle_circle(std::vector<uint32_t>& overlapping) const {
+  const CircleCircleBatch& batch = m_circle_circle;
+  size_t count = batch.pair.size();
+  size_t i = 0;
+
+#if defined(ZPHYSICS_SSE2) || defined(ZPHYSICS_NEON)
+  for (; i + k_lanes <= count; i += k_lanes) {
+    f4 dx = load4(&batch.dx[i]);
+    f4 dy = load4(&batch.dy[i]);
+    f4 r = load4(&batch.sum_radius[i]);
+    f4 distance_sq = add4(mul4(dx, dx), mul4(dy, dy));
+    m4 hit = less_equal4(distance_sq, mul4(r, r));
+    append_hits(mask_bits(hit), &batch.pair[i], overlapping);
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (circle_circle(batch.dx[i], batch.dy[i], batch.sum_radius[i])) {
+      overlapping.push_back(batch.pair[i]);
+    }
+  }
+}
+
+void NarrowPhase::run_rect_circle(std::vector<uint32_t>& overlapping) const {
+  const RectCircleBatch& batch = m_rect_circle;
+  size_t count = batch.pair.size();
+  size_t i = 0;
+
+#if defined(ZPHYSICS_SSE2) || defined(ZPHYSICS_NEON)
+  for (; i + k_lanes <= count; i += k_lanes) {
+    f4 dx = load4(&batch.dx[i]);
+    f4 dy = load4(&batch.dy[i]);
+    f4 half_width = load4(&batch.half_width[i]);
+    f4 half_height = load4(&batch.half_height[i]);
+    f4 r = load4(&batch.radius[i]);
+
+    // offset from the closest point of the rectangle to the circle center
+    f4 ex = sub4(dx, min4(max4(dx, neg4(half_width)), half_width));
+    f4 ey = sub4(dy, min4(max4(dy, neg4(half_height)), half_height));
+    f4 distance_sq = add4(mul4(ex, ex), mul4(ey, ey));
+    m4 hit = less_equal4(distance_sq, mul4(r, r));
+    append_hits(mask_bits(hit), &batch.pair[i], overlapping);
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (rect_circle(batch.dx[i], batch.dy[i], batch.half_width[i],
+                    batch.half_height[i], batch.radius[i])) {
+      overlapping.push_back(batch.pair[i]);
+    }
+  }
+}
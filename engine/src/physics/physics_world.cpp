@@ -0,0 +1,1030 @@
+#include "physics/physics_world.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include "config_manager/config_manager.h"
+#include "core/profiling.h"
+#include "core/query.h"
+#include "game/collider.h"
+#include "game/position.h"
+#include "game/velocity.h"
+
+static constexpr float k_min_cell_size = 8.0f;
+static constexpr float k_max_cell_size = 1024.0f;
+
+// how far a moving collider travels before it is reinserted into the tree
+static constexpr float k_dynamic_margin = 8.0f;
+
+// longest frame fed into the accumulator, anything above is a hitch
+static constexpr float k_max_frame_time = 0.25f;
+
+// a circle moving more than this fraction of its radius in one substep is
+// swept instead of just moved
+static constexpr float k_sweep_threshold = 0.5f;
+
+// how far a swept circle is pushed into what it hit, so the contact test of
+// the substep sees the overlap
+static constexpr float k_contact_slop = 0.01f;
+
+// time of impact of a point moving by (dx, dy) against a circle, 1 for none
+static float sweep_point_circle(float x, float y, float dx, float dy,
+                                float cx, float cy, float radius) {
+  float mx = x - cx;
+  float my = y - cy;
+  float a = dx * dx + dy * dy;
+  float b = mx * dx + my * dy;
+  float c = mx * mx + my * my - radius * radius;
+
+  if (a <= 0.0f || b >= 0.0f) return 1.0f;  // still or moving away
+
+  float discriminant = b * b - a * c;
+  if (discriminant < 0.0f) return 1.0f;
+
+  float t = (-b - std::sqrt(discriminant)) / a;
+  return t >= 0.0f && t < 1.0f ? t : 1.0f;
+}
+
+// time of impact of a circle moving by (dx, dy) against a rectangle, that is
+// the center against the rectangle with corners rounded by the radius
+static float sweep_circle_rect(float x, float y, float dx, float dy,
+                               float radius, const CollisionShape& rect) {
+  float min_x = rect.x - rect.half_width;
+  float min_y = rect.y - rect.half_height;
+  float max_x = rect.x + rect.half_width;
+  float max_y = rect.y + rect.half_height;
+
+  float t_enter = 0.0f;
+  float t_exit = 1.0f;
+
+  // slabs of the rectangle grown by the radius
+  auto clip = [&](float p, float d, float low, float high) {
+    if (d == 0.0f) return p >= low && p <= high;
+
+    float t0 = (low - p) / d;
+    float t1 = (high - p) / d;
+    if (t0 > t1) std::swap(t0, t1);
+
+    t_enter = std::max(t_enter, t0);
+    t_exit = std::min(t_exit, t1);
+    return t_enter <= t_exit;
+  };
+
+  if (!clip(x, dx, min_x - radius, max_x + radius)) return 1.0f;
+  if (!clip(y, dy, min_y - radius, max_y + radius)) return 1.0f;
+
+  float hit_x = x + dx * t_enter;
+  float hit_y = y + dy * t_enter;
+  bool face_x = hit_x >= min_x && hit_x <= max_x;
+  bool face_y = hit_y >= min_y && hit_y <= max_y;
+  if (face_x || face_y) return t_enter < 1.0f ? t_enter : 1.0f;
+
+  // entered through a corner square, only its rounded part counts
+  float corner_x = hit_x < min_x ? min_x : max_x;
+  float corner_y = hit_y < min_y ? min_y : max_y;
+  return sweep_point_circle(x, y, dx, dy, corner_x, corner_y, radius);
+}
+
+// fraction of the segment from (x, y) to (x + dx, y + dy) where it enters the
+// shape and the surface normal there, 1 when it misses. a segment starting
+// inside is hit at 0 and the normal faces back along it
+static float ray_shape(float x, float y, float dx, float dy,
+                       const CollisionShape& shape, float& nx, float& ny) {
+  auto inside = [&]() {
+    float length = std::sqrt(dx * dx + dy * dy);
+    nx = length > 0.0f ? -dx / length : 0.0f;
+    ny = length > 0.0f ? -dy / length : 0.0f;
+    return 0.0f;
+  };
+
+  if (shape.type == CollisionShape::Circle) {
+    float mx = x - shape.x;
+    float my = y - shape.y;
+    if (mx * mx + my * my <= shape.radius * shape.radius) return inside();
+
+    float t = sweep_point_circle(x, y, dx, dy, shape.x, shape.y, shape.radius);
+    if (t >= 1.0f) return 1.0f;
+
+    nx = (x + dx * t - shape.x) / shape.radius;
+    ny = (y + dy * t - shape.y) / shape.radius;
+    return t;
+  }
+
+  float t_enter = 0.0f;
+  float t_exit = 1.0f;
+  int axis = -1;  // the slab entered last, none when starting inside
+
+  auto clip = [&](int slab, float p, float d, float low, float high) {
+    if (d == 0.0f) return p >= low && p <= high;
+
+    float t0 = (low - p) / d;
+    float t1 = (high - p) / d;
+    if (t0 > t1) std::swap(t0, t1);
+
+    if (t0 > t_enter) {
+      t_enter = t0;
+      axis = slab;
+    }
+    t_exit = std::min(t_exit, t1);
+    return t_enter <= t_exit;
+  };
+
+  if (!clip(0, x, dx, shape.x - shape.half_width, shape.x + shape.half_width) ||
+      !clip(1, y, dy, shape.y - shape.half_height,
+            shape.y + shape.half_height)) {
+    return 1.0f;
+  }
+
+  if (axis == -1) return inside();
+  if (t_enter >= 1.0f) return 1.0f;
+
+  nx = axis == 0 ? (dx > 0.0f ? -1.0f : 1.0f) : 0.0f;
+  ny = axis == 1 ? (dy > 0.0f ? -1.0f : 1.0f) : 0.0f;
+  return t_enter;
+}
+
+// squared distance from a point to the shape, 0 inside
+static float distance_squared(const CollisionShape& shape, float x, float y) {
+  if (shape.type != CollisionShape::Circle) {
+    return shape.bounds().distance_squared(x, y);
+  }
+
+  float dx = x - shape.x;
+  float dy = y - shape.y;
+  float distance = std::max(std::sqrt(dx * dx + dy * dy) - shape.radius, 0.0f);
+  return distance * distance;
+}
+
+// direction that pushes the body out of the other shape, returns how deep
+// they overlap
+static float contact_normal(const CollisionShape& body,
+                            const CollisionShape& other, float& nx,
+                            float& ny) {
+  if (body.type == CollisionShape::Rectangle &&
+      other.type == CollisionShape::Circle) {
+    float depth = contact_normal(other, body, nx, ny);
+    nx = -nx;
+    ny = -ny;
+    return depth;
+  }
+
+  if (body.type == CollisionShape::Rectangle) {
+    float dx = body.x - other.x;
+    float dy = body.y - other.y;
+    float overlap_x = body.half_width + other.half_width - std::fabs(dx);
+    float overlap_y = body.half_height + other.half_height - std::fabs(dy);
+
+    // out along the shallower axis
+    nx = 0.0f;
+    ny = 0.0f;
+    if (overlap_x < overlap_y) {
+      nx = dx < 0.0f ? -1.0f : 1.0f;
+      return overlap_x;
+    }
+    ny = dy < 0.0f ? -1.0f : 1.0f;
+    return overlap_y;
+  }
+
+  // a circle, against the closest point of a rectangle or the other center
+  float target_x = other.x;
+  float target_y = other.y;
+  float reach = body.radius + other.radius;
+  if (other.type == CollisionShape::Rectangle) {
+    target_x = std::clamp(body.x, other.x - other.half_width,
+                          other.x + other.half_width);
+    target_y = std::clamp(body.y, other.y - other.half_height,
+                          other.y + other.half_height);
+    reach = body.radius;
+  }
+
+  nx = body.x - target_x;
+  ny = body.y - target_y;
+  float distance = std::sqrt(nx * nx + ny * ny);
+
+  // the center is inside, straight up like the ball always did
+  if (distance > 0.0f) {
+    nx /= distance;
+    ny /= distance;
+  } else {
+    nx = 0.0f;
+    ny = -1.0f;
+  }
+
+  return reach - distance;
+}
+
+PhysicsWorld::PhysicsWorld() {
+  // the grid suits many similarly sized movers better than the dynamic tree
+  m_use_grid = CONFIG_GET("physics_dynamic_grid", int, 0) != 0;
+  m_fixed_cell_size = (float)CONFIG_GET("physics_cell_size", int, 0);
+
+  int fixed_fps = CONFIG_GET("physics_fixed_fps", int, 60);
+  m_fixed_delta = 1.0f / (float)std::max(fixed_fps, 1);
+  m_substeps = std::max(CONFIG_GET("physics_substeps", int, 2), 1);
+  m_max_steps = std::max(CONFIG_GET("physics_max_steps", int, 5), 1);
+  m_threaded = CONFIG_GET("physics_threaded", int, 1) != 0;  // 0 runs inline
+
+  // physics_layer_<n>_mask holds the layers layer n meets, all when missing
+  for (int layer = 0; layer < k_layer_count; layer++) {
+    std::string key = "physics_layer_" + std::to_string(layer) + "_mask";
+    m_layer_masks[layer] = ConfigManager::get().has(key)
+                               ? (uint32_t)CONFIG_GET(key, int, -1)
+                               : ~0u;
+  }
+}
+
+PhysicsWorld::~PhysicsWorld() {
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_worker_running = false;
+  }
+  m_job_cv.notify_all();
+
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+}
+
+void PhysicsWorld::step(float frame_time) {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::step()");
+
+  wait_for_job();
+
+  update_broad_phase();
+  publish_results();
+  if (dispatch_events()) drop_disabled();
+  take_snapshot();
+
+  start_job(frame_time);
+}
+
+void PhysicsWorld::sync() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::sync()");
+
+  // events wait for the next step, handlers only run in the play update
+  wait_for_job();
+  update_broad_phase();
+  publish_results();
+  take_snapshot();
+}
+
+void PhysicsWorld::start_job(float frame_time) {
+  if (!m_threaded) {
+    simulate(frame_time);
+    return;
+  }
+
+  if (!m_worker.joinable()) {
+    m_worker = std::thread(&PhysicsWorld::worker_loop, this);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_job_frame_time = frame_time;
+    m_job_pending = true;
+  }
+  m_job_cv.notify_all();
+}
+
+void PhysicsWorld::wait_for_job() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::wait_for_job()");
+
+  std::unique_lock<std::mutex> lock(m_job_mutex);
+  m_job_cv.wait(lock, [this] { return !m_job_pending; });
+}
+
+void PhysicsWorld::worker_loop() {
+  while (true) {
+    float frame_time;
+    {
+      std::unique_lock<std::mutex> lock(m_job_mutex);
+      m_job_cv.wait(lock,
+                    [this] { return !m_worker_running || m_job_pending; });
+      if (!m_worker_running) return;
+      frame_time = m_job_frame_time;
+    }
+
+    simulate(frame_time);
+
+    {
+      std::lock_guard<std::mutex> lock(m_job_mutex);
+      m_job_pending = false;
+    }
+    m_job_cv.notify_all();
+  }
+}
+
+void PhysicsWorld::update_broad_phase() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::update_broad_phase()");
+
+  m_frame++;
+  m_removed.clear();
+  m_dynamic_proxies.clear();
+
+  bool static_changed = false;
+
+  Query::for_each<Collider>([&](Collider& collider) {
+    int32_t id = collider.m_proxy.id;
+    bool owned = id != PhysicsProxy::k_none &&
+                 id < (int32_t)m_proxies.size() &&
+                 m_proxies[id].collider == &collider;
+
+    bool usable = collider.is_enable() && !collider.is_dead &&
+                  collider.m_collider_type != 0;
+
+    if (owned && (!usable || !matches(m_proxies[id], collider))) {
+      static_changed |= m_proxies[id].is_static;
+      destroy_proxy(id);
+      owned = false;
+    }
+
+    if (!usable) {
+      collider.m_proxy.id = PhysicsProxy::k_none;
+      return;
+    }
+
+    if (!owned) {
+      id = create_proxy(collider);
+      static_changed |= collider.m_static;
+    }
+
+    Proxy& proxy = m_proxies[id];
+    proxy.seen_frame = m_frame;
+    proxy.is_trigger = collider.m_is_trigger;
+    proxy.is_listening = collider.has_contact_listeners();
+    proxy.category = (uint32_t)collider.m_category;
+    proxy.mask = (uint32_t)collider.m_mask & layer_mask(proxy.category);
+    if (!proxy.is_static) m_dynamic_proxies.push_back(id);
+  });
+
+  // colliders that left the storage since the last sync, their pointers are
+  // dangling so only the bookkeeping is touched
+  for (int32_t id = 0; id < (int32_t)m_proxies.size(); id++) {
+    const Proxy& proxy = m_proxies[id];
+    if (proxy.collider && proxy.seen_frame != m_frame) {
+      static_changed |= proxy.is_static;
+      m_removed.push_back(proxy.collider);
+      destroy_proxy(id);
+    }
+  }
+  std::sort(m_removed.begin(), m_removed.end());
+
+  // and they take their exits with them
+  if (!m_removed.empty()) {
+    auto is_removed = [this](const Contact& contact) {
+      return std::binary_search(m_removed.begin(), m_removed.end(),
+                                contact.a) ||
+             std::binary_search(m_removed.begin(), m_removed.end(),
+                                contact.b);
+    };
+    m_contacts.erase(
+        std::remove_if(m_contacts.begin(), m_contacts.end(), is_removed),
+        m_contacts.end());
+    m_previous_contacts.erase(
+        std::remove_if(m_previous_contacts.begin(), m_previous_contacts.end(),
+                       is_removed),
+        m_previous_contacts.end());
+  }
+
+  if (m_static_dirty) {
+    refresh_static();
+    static_changed = true;
+  }
+
+  if (static_changed) {
+    ZPROFILE_ZONE_NAMED("PhysicsWorld::rebuild_static()");
+    m_static_tree.rebuild();
+  }
+}
+
+// writes the transforms of the last job back to the storage
+void PhysicsWorld::publish_results() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::publish_results()");
+
+  m_contact_count = m_contacts.size();
+
+  for (const Body& body : m_bodies) {
+    const Proxy& proxy = m_proxies[body.proxy];
+    if (!proxy.collider || proxy.serial != body.serial) continue;
+
+    auto position = Query::try_get<Position>(proxy.entity);
+    auto velocity = Query::try_get<Velocity>(proxy.entity);
+    if (!position || !velocity) continue;
+
+    // whatever a script wrote since the snapshot wins
+    Position& p = position->get();
+    if (p.x == body.start_x && p.y == body.start_y) {
+      p.x = m_shapes[body.proxy].x;
+      p.y = m_shapes[body.proxy].y;
+    }
+
+    Velocity& v = velocity->get();
+    if (v.x == body.start_vx && v.y == body.start_vy) {
+      v.x = body.vx;
+      v.y = body.vy;
+    }
+  }
+}
+
+// handlers may change the colliders but must not remove them from the storage
+bool PhysicsWorld::dispatch_events() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::dispatch_events()");
+
+  auto is_removed = [this](Collider* collider) {
+    return std::binary_search(m_removed.begin(), m_removed.end(), collider);
+  };
+
+  // handlers commonly disable what they hit, later events of it are dropped
+  auto is_disabled = [](Collider* collider) {
+    return !collider->is_enable() || collider->is_dead;
+  };
+
+  for (const ContactEvent& event : m_events) {
+    if (is_removed(event.a) || is_removed(event.b)) continue;
+    if (is_disabled(event.a) || is_disabled(event.b)) continue;
+
+    switch (event.kind) {
+      case ContactEvent::Enter:
+        event.a->m_on_collision_enter.emit(*event.b);
+        event.b->m_on_collision_enter.emit(*event.a);
+        break;
+      case ContactEvent::Stay:
+        event.a->m_on_collision_stay.emit(*event.b);
+        event.b->m_on_collision_stay.emit(*event.a);
+        break;
+      case ContactEvent::Exit:
+        event.a->m_on_collision_exit.emit(*event.b);
+        event.b->m_on_collision_exit.emit(*event.a);
+        break;
+    }
+  }
+
+  bool any = !m_events.empty();
+  m_events.clear();
+  return any;
+}
+
+// handlers commonly disable what they hit, it shouldn't take part in the next
+// job
+void PhysicsWorld::drop_disabled() {
+  bool static_changed = false;
+  for (int32_t id = 0; id < (int32_t)m_proxies.size(); id++) {
+    Collider* collider = m_proxies[id].collider;
+    if (!collider || (collider->is_enable() && !collider->is_dead)) continue;
+
+    static_changed |= m_proxies[id].is_static;
+    collider->m_proxy.id = PhysicsProxy::k_none;
+    destroy_proxy(id);
+  }
+
+  m_dynamic_proxies.erase(
+      std::remove_if(m_dynamic_proxies.begin(), m_dynamic_proxies.end(),
+                     [this](int32_t id) { return !m_proxies[id].collider; }),
+      m_dynamic_proxies.end());
+
+  if (static_changed) {
+    m_static_tree.rebuild();
+  }
+}
+
+// copies what the job needs out of the storage
+void PhysicsWorld::take_snapshot() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::take_snapshot()");
+
+  m_shapes.resize(m_proxies.size());
+  m_body_of_proxy.assign(m_proxies.size(), -1);
+  m_bodies.clear();
+
+  for (int32_t id : m_dynamic_proxies) {
+    Proxy& proxy = m_proxies[id];
+    m_shapes[id] = proxy.collider->get_shape();
+
+    auto velocity = Query::try_get<Velocity>(proxy.entity);
+    proxy.is_body = velocity.has_value();
+    if (!proxy.is_body) continue;
+
+    const Velocity& v = velocity->get();
+    const CollisionShape& shape = m_shapes[id];
+    m_body_of_proxy[id] = (int32_t)m_bodies.size();
+    m_bodies.push_back(
+        Body{id, proxy.serial, shape.x, shape.y, v.x, v.y, v.x, v.y});
+  }
+
+  // moving colliders may have been moved by scripts since the last sync
+  refit_dynamic();
+
+  if (m_use_grid) {
+    m_published_grid = m_grid;
+    m_published_grid_proxies = m_grid_proxies;
+  } else {
+    m_published_tree = m_dynamic_tree;
+  }
+}
+
+void PhysicsWorld::simulate(float frame_time) {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::simulate()");
+
+  m_accumulator += std::min(frame_time, k_max_frame_time);
+
+  int steps = 0;
+  while (m_accumulator >= m_fixed_delta && steps < m_max_steps) {
+    fixed_step();
+    m_accumulator -= m_fixed_delta;
+    steps++;
+  }
+
+  // nothing moved, the contacts are those of the last frame still
+  if (steps > 0) record_events();
+
+  // too far behind, slow the simulation down instead of spiralling
+  if (steps == m_max_steps) {
+    m_accumulator = std::min(m_accumulator, m_fixed_delta);
+  }
+}
+
+void PhysicsWorld::fixed_step() {
+  float delta = m_fixed_delta / m_substeps;
+  for (int substep = 0; substep < m_substeps; substep++) {
+    integrate(delta);
+    refit_dynamic();
+    find_contacts();
+    resolve_contacts();
+    collect_contacts();
+  }
+}
+
+void PhysicsWorld::refit_dynamic() {
+  m_grid_proxies.clear();
+  m_grid_bounds.clear();
+
+  for (int32_t id : m_dynamic_proxies) {
+    Aabb bounds = m_shapes[id].bounds();
+    if (m_use_grid) {
+      m_grid_proxies.push_back(id);
+      m_grid_bounds.push_back(bounds);
+    } else {
+      m_dynamic_tree.move_proxy(m_proxies[id].node, bounds, k_dynamic_margin);
+    }
+  }
+
+  if (m_use_grid) {
+    m_grid.set_cell_size(m_fixed_cell_size > 0.0f ? m_fixed_cell_size
+                                                   : derive_cell_size());
+    m_grid.build(m_grid_bounds);
+  }
+}
+
+void PhysicsWorld::integrate(float delta) {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::integrate()");
+
+  for (const Body& body : m_bodies) {
+    const Proxy& proxy = m_proxies[body.proxy];
+    CollisionShape& shape = m_shapes[body.proxy];
+
+    float dx = body.vx * delta;
+    float dy = body.vy * delta;
+    if (dx == 0.0f && dy == 0.0f) continue;
+
+    float radius = shape.radius;
+    bool is_fast = dx * dx + dy * dy > (k_sweep_threshold * radius) *
+                                           (k_sweep_threshold * radius);
+
+    // triggers pass through everything anyway
+    if (shape.type == CollisionShape::Circle && !proxy.is_trigger &&
+        is_fast) {
+      float toi = sweep_circle(body.proxy, shape.x, shape.y, dx, dy);
+      if (toi < 1.0f) {
+        float length = std::sqrt(dx * dx + dy * dy);
+        shape.x += dx * toi + dx / length * k_contact_slop;
+        shape.y += dy * toi + dy / length * k_contact_slop;
+        continue;
+      }
+    }
+
+    shape.x += dx;
+    shape.y += dy;
+  }
+}
+
+float PhysicsWorld::sweep_circle(int32_t id, float x, float y, float dx,
+                                 float dy) const {
+  const Proxy& proxy = m_proxies[id];
+  float radius = proxy.shape.radius;
+
+  Aabb start{x - radius, y - radius, x + radius, y + radius};
+  Aabb end{start.min_x + dx, start.min_y + dy, start.max_x + dx,
+           start.max_y + dy};
+
+  float toi = 1.0f;
+
+  visit_proxies(start.merged(end), [&](uint32_t other_id) {
+    const Proxy& other = m_proxies[other_id];
+    if ((int32_t)other_id == id) return;
+    if (other.is_trigger || other.entity == proxy.entity) return;
+    if (!can_collide(proxy, other)) return;
+
+    const CollisionShape& shape = get_shape(other_id);
+    CollisionShape circle = proxy.shape;
+    circle.x = x;
+    circle.y = y;
+
+    // already touching, that contact is the discrete test's business
+    if (NarrowPhase::overlaps(circle, shape)) return;
+
+    float t = shape.type == CollisionShape::Circle
+                  ? sweep_point_circle(x, y, dx, dy, shape.x, shape.y,
+                                       radius + shape.radius)
+                  : sweep_circle_rect(x, y, dx, dy, radius, shape);
+    toi = std::min(toi, t);
+  });
+
+  return toi;
+}
+
+void PhysicsWorld::clear() {
+  wait_for_job();
+
+  m_proxies.clear();
+  m_free_proxies.clear();
+  m_proxy_count = 0;
+  m_static_tree.clear();
+  m_dynamic_tree.clear();
+  m_published_tree.clear();
+  m_grid.clear();
+  m_grid_proxies.clear();
+  m_grid_bounds.clear();
+  m_published_grid.clear();
+  m_published_grid_proxies.clear();
+  m_static_dirty = false;
+  m_contacts.clear();
+  m_frame_contacts.clear();
+  m_previous_contacts.clear();
+  m_events.clear();
+  m_removed.clear();
+  m_contact_count = 0;
+  m_dynamic_proxies.clear();
+  m_bodies.clear();
+  m_body_of_proxy.clear();
+  m_shapes.clear();
+  m_accumulator = 0.0f;
+}
+
+bool PhysicsWorld::raycast(float x, float y, float dx, float dy,
+                           uint32_t layers, RaycastResult& result) const {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::raycast()");
+
+  result = RaycastResult();
+
+  auto test = [&](uint32_t id, float max_fraction) {
+    Collider* collider = live_collider(id, layers);
+    if (!collider) return max_fraction;
+
+    float nx, ny;
+    const Proxy& proxy = m_proxies[id];
+    float t = ray_shape(x, y, dx, dy,
+                        proxy.is_static ? proxy.shape : collider->get_shape(),
+                        nx, ny);
+    if (t >= max_fraction) return max_fraction;
+
+    result = RaycastResult{collider, t, nx, ny};
+    return t;
+  };
+
+  m_static_tree.raycast(x, y, dx, dy, 1.0f, test);
+
+  float max_fraction = result.fraction;
+  if (max_fraction <= 0.0f) return true;
+
+  if (m_use_grid) {
+    // grid colliders are small, the bounds of the segment are close enough
+    Aabb box{std::min(x, x + dx), std::min(y, y + dy), std::max(x, x + dx),
+             std::max(y, y + dy)};
+    m_published_grid.query(box, [&](uint32_t i) {
+      max_fraction = test(m_published_grid_proxies[i], max_fraction);
+    });
+  } else {
+    m_published_tree.raycast(x, y, dx, dy, max_fraction, test);
+  }
+
+  return result.collider != nullptr;
+}
+
+void PhysicsWorld::overlap(const CollisionShape& shape, uint32_t layers,
+                           std::vector<Collider*>& colliders) const {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::overlap()");
+
+  visit_published(shape.bounds(), [&](uint32_t id) {
+    Collider* collider = live_collider(id, layers);
+    if (!collider) return;
+
+    const Proxy& proxy = m_proxies[id];
+    if (NarrowPhase::overlaps(
+            shape, proxy.is_static ? proxy.shape : collider->get_shape())) {
+      colliders.push_back(collider);
+    }
+  });
+}
+
+void PhysicsWorld::nearest(float x, float y, size_t count, uint32_t layers,
+                           std::vector<Collider*>& colliders) const {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::nearest()");
+
+  if (count == 0) return;
+
+  // closest so far by squared distance, sorted
+  std::vector<std::pair<float, Collider*>> best;
+  auto worst = [&]() {
+    return best.size() < count ? std::numeric_limits<float>::infinity()
+                               : best.back().first;
+  };
+
+  auto consider = [&](uint32_t id) {
+    Collider* collider = live_collider(id, layers);
+    if (!collider) return;
+
+    const Proxy& proxy = m_proxies[id];
+    float distance_sq = distance_squared(
+        proxy.is_static ? proxy.shape : collider->get_shape(), x, y);
+    if (distance_sq >= worst()) return;
+
+    std::pair<float, Collider*> entry(distance_sq, collider);
+    best.insert(std::upper_bound(best.begin(), best.end(), entry,
+                                 [](const auto& lhs, const auto& rhs) {
+                                   return lhs.first < rhs.first;
+                                 }),
+                entry);
+    if (best.size() > count) best.pop_back();
+  };
+
+  // a shape is never closer than its bounds, so the walk ends once the
+  // bounds are further than the worst of the best
+  auto visit_tree = [&](const AabbTree& tree) {
+    tree.visit_nearest(x, y, [&](uint32_t id, float bounds_distance_sq) {
+      if (bounds_distance_sq > worst()) return false;
+      consider(id);
+      return true;
+    });
+  };
+
+  visit_tree(m_static_tree);
+
+  if (m_use_grid) {
+    // growing boxes, a collider not found yet is further than the reach
+    size_t total = m_published_grid.get_proxy_count();
+    std::vector<bool> seen(total, false);
+    size_t seen_count = 0;
+    float reach = m_published_grid.get_cell_size();
+
+    while (seen_count < total) {
+      Aabb box{x - reach, y - reach, x + reach, y + reach};
+      m_published_grid.query(box, [&](uint32_t i) {
+        if (seen[i]) return;
+        seen[i] = true;
+        seen_count++;
+        consider(m_published_grid_proxies[i]);
+      });
+
+      if (worst() <= reach * reach) break;
+      reach *= 2.0f;
+    }
+  } else {
+    visit_tree(m_published_tree);
+  }
+
+  for (const auto& entry : best) {
+    colliders.push_back(entry.second);
+  }
+}
+
+Collider* PhysicsWorld::live_collider(uint32_t id, uint32_t layers) const {
+  const Proxy& proxy = m_proxies[id];
+  if (!proxy.collider || !(proxy.category & layers)) return nullptr;
+
+  auto collider = Query::try_get<Collider>(proxy.entity);
+  if (!collider || &collider->get() != proxy.collider) return nullptr;
+  return collider->get().is_enable() ? proxy.collider : nullptr;
+}
+
+int32_t PhysicsWorld::create_proxy(Collider& collider) {
+  int32_t id;
+  if (m_free_proxies.empty()) {
+    id = (int32_t)m_proxies.size();
+    m_proxies.emplace_back();
+  } else {
+    id = m_free_proxies.back();
+    m_free_proxies.pop_back();
+  }
+
+  Proxy& proxy = m_proxies[id];
+  proxy = Proxy();
+  proxy.collider = &collider;
+  proxy.entity = collider.entity_id;
+  proxy.serial = ++m_next_serial;
+  proxy.is_static = collider.m_static;
+  proxy.shape = collider.get_shape();
+
+  // grid proxies are collected every update instead
+  if (proxy.is_static) {
+    proxy.node = m_static_tree.create_proxy(proxy.shape.bounds(), id);
+  } else if (!m_use_grid) {
+    proxy.node = m_dynamic_tree.create_proxy(proxy.shape.bounds(), id,
+                                             k_dynamic_margin);
+  }
+
+  collider.m_proxy.id = id;
+  m_proxy_count++;
+  return id;
+}
+
+void PhysicsWorld::destroy_proxy(int32_t id) {
+  Proxy& proxy = m_proxies[id];
+
+  if (proxy.node != AabbTree::k_null) {
+    AabbTree& tree = proxy.is_static ? m_static_tree : m_dynamic_tree;
+    tree.destroy_proxy(proxy.node);
+  }
+
+  proxy = Proxy();
+  m_free_proxies.push_back(id);
+  m_proxy_count--;
+}
+
+void PhysicsWorld::find_contacts() {
+  ZPROFILE_ZONE_NAMED("PhysicsWorld::find_contacts()");
+
+  m_contacts.clear();
+  m_candidates.clear();
+  m_narrow_phase.clear();
+
+  // only pairs with a body or a listener on either side are worth testing,
+  // and a pair of two of them is only collected from its lower id
+  auto is_interested = [](const Proxy& proxy) {
+    return proxy.is_listening || proxy.is_body;
+  };
+
+  for (int32_t id = 0; id < (int32_t)m_proxies.size(); id++) {
+    const Proxy& proxy = m_proxies[id];
+    if (!proxy.collider || !is_interested(proxy)) continue;
+
+    const CollisionShape& shape = get_shape(id);
+
+    visit_proxies(shape.bounds(), [&](uint32_t other_id) {
+      const Proxy& other = m_proxies[other_id];
+      if ((int32_t)other_id == id) return;
+      if (is_interested(other) && (int32_t)other_id < id) return;
+      if (other.entity == proxy.entity || !can_collide(proxy, other)) return;
+
+      bool ordered = proxy.serial < other.serial;
+      int32_t a = ordered ? id : (int32_t)other_id;
+      int32_t b = ordered ? (int32_t)other_id : id;
+
+      m_narrow_phase.add(m_candidates.size(), shape, get_shape(other_id));
+      m_candidates.push_back(
+          Contact{(uint64_t(m_proxies[a].serial) << 32) | m_proxies[b].serial,
+                  m_proxies[a].collider, m_proxies[b].collider, a, b});
+    });
+  }
+
+  m_hits.clear();
+  m_narrow_phase.run(m_hits);
+
+  for (uint32_t hit : m_hits) {
+    m_contacts.push_back(m_candidates[hit]);
+  }
+
+  std::sort(m_contacts.begin(), m_contacts.end(),
+            [](const Contact& lhs, const Contact& rhs) {
+              return lhs.key < rhs.key;
+            });
+}
+
+// bodies bounce off the solid colliders they overlap
+void PhysicsWorld::resolve_contacts() {
+  for (const Contact& contact : m_contacts) {
+    resolve(contact.proxy_a, contact.proxy_b);
+    resolve(contact.proxy_b, contact.proxy_a);
+  }
+}
+
+void PhysicsWorld::resolve(int32_t body_proxy, int32_t other_proxy) {
+  int32_t index = m_body_of_proxy[body_proxy];
+  if (index < 0) return;
+  if (m_proxies[body_proxy].is_trigger || m_proxies[other_proxy].is_trigger) {
+    return;
+  }
+
+  Body& body = m_bodies[index];
+  CollisionShape& shape = m_shapes[body_proxy];
+
+  float nx, ny;
+  float depth = contact_normal(shape, get_shape(other_proxy), nx, ny);
+  if (depth > 0.0f) {
+    shape.x += nx * depth;
+    shape.y += ny * depth;
+  }
+
+  // reflect only when moving into it, so a pair that stays in contact for a
+  // few substeps doesn't flip back and forth
+  float dot = body.vx * nx + body.vy * ny;
+  if (dot < 0.0f) {
+    body.vx -= 2.0f * dot * nx;
+    body.vy -= 2.0f * dot * ny;
+  }
+}
+
+// a pair that touched in any substep touched in the frame
+void PhysicsWorld::collect_contacts() {
+  m_frame_contacts.insert(m_frame_contacts.end(), m_contacts.begin(),
+                          m_contacts.end());
+}
+
+// merges the sorted contact sets of this frame and the previous one
+void PhysicsWorld::record_events() {
+  auto by_key = [](const Contact& lhs, const Contact& rhs) {
+    return lhs.key < rhs.key;
+  };
+  std::sort(m_frame_contacts.begin(), m_frame_contacts.end(), by_key);
+  m_frame_contacts.erase(
+      std::unique(m_frame_contacts.begin(), m_frame_contacts.end(),
+                  [](const Contact& lhs, const Contact& rhs) {
+                    return lhs.key == rhs.key;
+                  }),
+      m_frame_contacts.end());
+
+  const std::vector<Contact>& frame = m_frame_contacts;
+  const std::vector<Contact>& last = m_previous_contacts;
+  size_t current = 0;
+  size_t previous = 0;
+
+  while (current < frame.size() || previous < last.size()) {
+    bool has_current = current < frame.size();
+    bool has_previous = previous < last.size();
+
+    if (has_current && has_previous &&
+        frame[current].key == last[previous].key) {
+      const Contact& contact = frame[current++];
+      previous++;
+      m_events.push_back(
+          ContactEvent{ContactEvent::Stay, contact.a, contact.b});
+    } else if (has_current &&
+               (!has_previous || frame[current].key < last[previous].key)) {
+      const Contact& contact = frame[current++];
+      m_events.push_back(
+          ContactEvent{ContactEvent::Enter, contact.a, contact.b});
+    } else {
+      const Contact& contact = last[previous++];
+      m_events.push_back(
+          ContactEvent{ContactEvent::Exit, contact.a, contact.b});
+    }
+  }
+
+  std::swap(m_frame_contacts, m_previous_contacts);
+  m_frame_contacts.clear();
+}
+
+bool PhysicsWorld::matches(const Proxy& proxy,
+                           const Collider& collider) const {
+  return proxy.is_static == collider.m_static &&
+         proxy.shape.type == collider.m_collider_type &&
+         proxy.shape.half_width == collider.m_width / 2 &&
+         proxy.shape.half_height == collider.m_height / 2 &&
+         proxy.shape.radius == collider.m_radius;
+}
+
+uint32_t PhysicsWorld::layer_mask(uint32_t category) const {
+  uint32_t mask = 0;
+  for (int layer = 0; category; layer++, category >>= 1) {
+    if (category & 1) mask |= m_layer_masks[layer];
+  }
+  return mask;
+}
+
+CollisionShape PhysicsWorld::resolve_shape(const Collider& collider) {
+  return collider.get_shape();
+}
+
+void PhysicsWorld::refresh_static() {
+  m_static_dirty = false;
+
+  for (int32_t id = 0; id < (int32_t)m_proxies.size(); id++) {
+    Proxy& proxy = m_proxies[id];
+    if (!proxy.collider || !proxy.is_static) continue;
+
+    proxy.shape = proxy.collider->get_shape();
+    m_static_tree.destroy_proxy(proxy.node);
+    proxy.node = m_static_tree.create_proxy(proxy.shape.bounds(), id);
+  }
+}
+
+float PhysicsWorld::derive_cell_size() const {
+  if (m_grid_bounds.empty()) return m_grid.get_cell_size();
+
+  // the mean extent keeps a typical collider within about four cells
+  float total = 0.0f;
+  for (const Aabb& bounds : m_grid_bounds) {
+    total += std::max(bounds.width(), bounds.height());
+  }
+
+  float mean = total / m_grid_bounds.size();
+  return std::clamp(mean, k_min_cell_size, k_max_cell_size);
+}
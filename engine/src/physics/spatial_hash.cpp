@@ -0,0 +1,96 @@
+#include "physics/spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+
+// a proxy covering more cells than this is tested against every query instead
+// of being copied into all of them, walls and backgrounds end up here
+static constexpr size_t k_max_cells_per_proxy = 64;
+
+// keeps cell coordinates inside int32 for far away or broken positions
+static constexpr float k_max_cell_coord = 1073741824.0f;
+
+void SpatialHash::set_cell_size(float cell_size) {
+  if (cell_size <= 0.0f) return;
+
+  m_cell_size = cell_size;
+  m_inv_cell_size = 1.0f / cell_size;
+}
+
+void SpatialHash::build(const std::vector<Aabb>& bounds) {
+  m_bounds = bounds;
+  m_scratch.clear();
+  m_oversized.clear();
+
+  for (uint32_t proxy = 0; proxy < m_bounds.size(); proxy++) {
+    CellRange range = cell_range(m_bounds[proxy]);
+    if (range.count() > k_max_cells_per_proxy) {
+      m_oversized.push_back(proxy);
+      continue;
+    }
+
+    for (int32_t y = range.min_y; y <= range.max_y; y++) {
+      for (int32_t x = range.min_x; x <= range.max_x; x++) {
+        m_scratch.push_back(Entry{cell_key(x, y), proxy});
+      }
+    }
+  }
+
+  // about two buckets per entry keeps unrelated cells mostly apart
+  m_bucket_bits = 4;
+  while ((size_t(1) << m_bucket_bits) < m_scratch.size() * 2) {
+    m_bucket_bits++;
+  }
+  size_t bucket_count = size_t(1) << m_bucket_bits;
+
+  // counting sort of the entries by bucket
+  m_bucket_start.assign(bucket_count + 1, 0);
+  for (const Entry& entry : m_scratch) {
+    m_bucket_start[bucket_index(entry.cell) + 1]++;
+  }
+  for (size_t i = 1; i <= bucket_count; i++) {
+    m_bucket_start[i] += m_bucket_start[i - 1];
+  }
+
+  m_entries.resize(m_scratch.size());
+  for (const Entry& entry : m_scratch) {
+    size_t bucket = bucket_index(entry.cell);
+    // bucket_start[bucket] is used as the write cursor and ends up at the
+    // start of the next bucket, shifted back below
+    m_entries[m_bucket_start[bucket]++] = entry;
+  }
+  for (size_t i = bucket_count; i > 0; i--) {
+    m_bucket_start[i] = m_bucket_start[i - 1];
+  }
+  m_bucket_start[0] = 0;
+
+  m_stamps.assign(m_bounds.size(), 0);
+  m_stamp = 0;
+}
+
+void SpatialHash::clear() {
+  m_bounds.clear();
+  m_entries.clear();
+  m_oversized.clear();
+  m_stamps.clear();
+  m_bucket_bits = 4;
+  m_bucket_start.assign((size_t(1) << m_bucket_bits) + 1, 0);
+}
+
+SpatialHash::CellRange SpatialHash::cell_range(const Aabb& box) const {
+  return CellRange{cell_coord(box.min_x), cell_coord(box.min_y),
+                   cell_coord(box.max_x), cell_coord(box.max_y)};
+}
+
+int32_t SpatialHash::cell_coord(float value) const {
+  float cell = std::floor(value * m_inv_cell_size);
+  if (!(cell > -k_max_cell_coord)) return int32_t(-k_max_cell_coord);
+  if (cell > k_max_cell_coord) return int32_t(k_max_cell_coord);
+  return int32_t(cell);
+}
+
+void SpatialHash::next_stamp() const {
+  if (++m_stamp == 0) {
+    std::fill(m_stamps.begin(), m_stamps.end(), 0);
+    m_stamp = 1;
+  }
+}
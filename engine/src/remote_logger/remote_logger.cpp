@@ -35,8 +35,9 @@ void RemoteLogger::log(LogLevel level, const std::string& message) {
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   doc.Accept(writer);
 
-  EditorEventBus::get().publish<const std::string&>(EditorEvent::LogToEditor,
-                                                    buffer.GetString());
+  // may be called from any thread, sent from the main thread on flush
+  EditorEventBus::get().post<EditorEvent::LogToEditor>(
+      std::string(buffer.GetString(), buffer.GetSize()));
 }
 
 #endif
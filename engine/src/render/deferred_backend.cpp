@@ -0,0 +1,209 @@
+#include "render/deferred_backend.h"
+#include <cassert>
+#include <cstring>
+
+void DeferredBackend::clear() {
+  m_calls.clear();
+  m_vertices.clear();
+  m_text.clear();
+}
+
+DeferredBackend::Call& DeferredBackend::push(Op op) {
+  Call& call = m_calls.emplace_back();
+  call = Call{};
+  call.op = op;
+  return call;
+}
+
+void DeferredBackend::replay(RenderBackend& backend) const {
+  for (const Call& call : m_calls) {
+    switch (call.op) {
+      case Op::BeginDrawing:
+        backend.begin_drawing();
+        break;
+      case Op::EndDrawing:
+        backend.end_drawing();
+        break;
+      case Op::BeginMode2D:
+        backend.begin_mode2d(call.camera);
+        break;
+      case Op::EndMode2D:
+        backend.end_mode2d();
+        break;
+      case Op::BeginTextureMode:
+        backend.begin_texture_mode(call.target);
+        break;
+      case Op::EndTextureMode:
+        backend.end_texture_mode();
+        break;
+      case Op::BeginScissorMode:
+        backend.begin_scissor_mode((int)call.rect.x, (int)call.rect.y,
+                                   (int)call.rect.width,
+                                   (int)call.rect.height);
+        break;
+      case Op::EndScissorMode:
+        backend.end_scissor_mode();
+        break;
+      case Op::ClearBackground:
+        backend.clear_background(call.color);
+        break;
+      case Op::Line:
+        backend.draw_line(call.point, call.end, call.color);
+        break;
+      case Op::Circle:
+        backend.draw_circle(call.point, call.value, call.color);
+        break;
+      case Op::CircleLines:
+        backend.draw_circle_lines(call.point, call.value, call.color);
+        break;
+      case Op::Rectangle:
+        backend.draw_rectangle(call.rect, call.color);
+        break;
+      case Op::RectangleLines:
+        backend.draw_rectangle_lines(call.rect, call.value, call.color);
+        break;
+      case Op::Text:
+        backend.draw_text(&m_text[call.first], call.point, (int)call.value,
+                          call.color);
+        break;
+      case Op::Texture:
+        backend.draw_texture(call.texture, call.source, call.rect, call.point,
+                             call.value, call.color);
+        break;
+      case Op::Triangles:
+        backend.draw_triangles(call.texture.id, &m_vertices[call.first],
+                               call.count);
+        break;
+    }
+  }
+}
+
+void DeferredBackend::begin_drawing() { push(Op::BeginDrawing); }
+
+void DeferredBackend::end_drawing() { push(Op::EndDrawing); }
+
+void DeferredBackend::begin_mode2d(const Camera2D& camera) {
+  push(Op::BeginMode2D).camera = camera;
+}
+
+void DeferredBackend::end_mode2d() { push(Op::EndMode2D); }
+
+void DeferredBackend::begin_texture_mode(const RenderTexture2D& target) {
+  push(Op::BeginTextureMode).target = target;
+}
+
+void DeferredBackend::end_texture_mode() { push(Op::EndTextureMode); }
+
+void DeferredBackend::begin_scissor_mode(int x, int y, int width,
+                                         int height) {
+  push(Op::BeginScissorMode).rect =
+      Rectangle{(float)x, (float)y, (float)width, (float)height};
+}
+
+void DeferredBackend::end_scissor_mode() { push(Op::EndScissorMode); }
+
+void DeferredBackend::clear_background(Color color) {
+  push(Op::ClearBackground).color = color;
+}
+
+void DeferredBackend::draw_line(Vector2 start, Vector2 end, Color color) {
+  Call& call = push(Op::Line);
+  call.point = start;
+  call.end = end;
+  call.color = color;
+}
+
+void DeferredBackend::draw_circle(Vector2 center, float radius, Color color) {
+  Call& call = push(Op::Circle);
+  call.point = center;
+  call.value = radius;
+  call.color = color;
+}
+
+void DeferredBackend::draw_circle_lines(Vector2 center, float radius,
+                                        Color color) {
+  Call& call = push(Op::CircleLines);
+  call.point = center;
+  call.value = radius;
+  call.color = color;
+}
+
+void DeferredBackend::draw_rectangle(Rectangle rect, Color color) {
+  Call& call = push(Op::Rectangle);
+  call.rect = rect;
+  call.color = color;
+}
+
+void DeferredBackend::draw_rectangle_lines(Rectangle rect, float thickness,
+                                           Color color) {
+  Call& call = push(Op::RectangleLines);
+  call.rect = rect;
+  call.value = thickness;
+  call.color = color;
+}
+
+void DeferredBackend::draw_text(const char* text, Vector2 position,
+                                int font_size, Color color) {
+  Call& call = push(Op::Text);
+  call.point = position;
+  call.value = (float)font_size;
+  call.color = color;
+  call.first = m_text.size();
+  m_text.append(text, std::strlen(text) + 1);
+}
+
+void DeferredBackend::draw_texture(const Texture2D& texture, Rectangle source,
+                                   Rectangle dest, Vector2 origin,
+                                   float rotation, Color tint) {
+  Call& call = push(Op::Texture);
+  call.texture = texture;
+  call.source = source;
+  call.rect = dest;
+  call.point = origin;
+  call.value = rotation;
+  call.color = tint;
+}
+
+void DeferredBackend::draw_triangles(unsigned int texture,
+                                     const RenderVertex* vertices,
+                                     size_t count) {
+  if (count == 0) return;
+
+  Call& call = push(Op::Triangles);
+  call.texture.id = texture;
+  call.first = m_vertices.size();
+  call.count = count;
+  m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+}
+
+Texture2D DeferredBackend::load_texture(const char*) {
+  assert(!"textures are loaded on the main thread");
+  return Texture2D{};
+}
+
+Texture2D DeferredBackend::load_texture_from_image(const Image&) {
+  assert(!"textures are loaded on the main thread");
+  return Texture2D{};
+}
+
+void DeferredBackend::update_texture(const Texture2D&, const void*) {
+  assert(!"textures are updated on the main thread");
+}
+
+void DeferredBackend::unload_texture(const Texture2D&) {
+  assert(!"textures are unloaded on the main thread");
+}
+
+RenderTexture2D DeferredBackend::load_render_texture(int, int) {
+  assert(!"render textures are loaded on the main thread");
+  return RenderTexture2D{};
+}
+
+void DeferredBackend::unload_render_texture(const RenderTexture2D&) {
+  assert(!"render textures are unloaded on the main thread");
+}
+
+Font DeferredBackend::get_font_default() {
+  assert(!"the font is laid out on the main thread");
+  return Font{};
+}
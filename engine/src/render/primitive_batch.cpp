@@ -0,0 +1,144 @@
+#include "render/primitive_batch.h"
+#include <algorithm>
+#include <cmath>
+
+PrimitiveBatch::PrimitiveBatch() {
+  for (int i = 0; i <= k_circle_segments; i++) {
+    float angle = 2.0f * PI * i / k_circle_segments;
+    m_cos[i] = std::cos(angle);
+    m_sin[i] = std::sin(angle);
+  }
+}
+
+void PrimitiveBatch::add_quad(Vector2 a, Vector2 b, Vector2 c, Vector2 d,
+                              Color color) {
+  add_vertex(a, color);
+  add_vertex(b, color);
+  add_vertex(c, color);
+
+  add_vertex(a, color);
+  add_vertex(c, color);
+  add_vertex(d, color);
+}
+
+void PrimitiveBatch::add_rectangle(Rectangle rect, Color color) {
+  use_texture(0);
+  float right = rect.x + rect.width;
+  float bottom = rect.y + rect.height;
+  add_quad(Vector2{rect.x, rect.y}, Vector2{rect.x, bottom},
+           Vector2{right, bottom}, Vector2{right, rect.y}, color);
+}
+
+void PrimitiveBatch::add_rectangle_lines(Rectangle rect, float thickness,
+                                         Color color) {
+  // thicker than the rectangle, the sides meet in the middle
+  if (thickness > rect.width || thickness > rect.height) {
+    if (rect.width > rect.height) {
+      thickness = rect.height / 2;
+    } else if (rect.width < rect.height) {
+      thickness = rect.width / 2;
+    }
+  }
+
+  float inner_height = rect.height - 2 * thickness;
+  add_rectangle(Rectangle{rect.x, rect.y, rect.width, thickness}, color);
+  add_rectangle(Rectangle{rect.x, rect.y + rect.height - thickness,
+                          rect.width, thickness},
+                color);
+  add_rectangle(Rectangle{rect.x, rect.y + thickness, thickness, inner_height},
+                color);
+  add_rectangle(Rectangle{rect.x + rect.width - thickness, rect.y + thickness,
+                          thickness, inner_height},
+                color);
+}
+
+void PrimitiveBatch::add_circle(Vector2 center, float radius, Color color) {
+  use_texture(0);
+  for (int i = 0; i < k_circle_segments; i++) {
+    add_vertex(center, color);
+    add_vertex(Vector2{center.x + m_cos[i + 1] * radius,
+                       center.y + m_sin[i + 1] * radius},
+               color);
+    add_vertex(
+        Vector2{center.x + m_cos[i] * radius, center.y + m_sin[i] * radius},
+        color);
+  }
+}
+
+void PrimitiveBatch::add_circle_lines(Vector2 center, float radius,
+                                      Color color) {
+  use_texture(0);
+  float outer = radius + 0.5f;
+  float inner = std::max(radius - 0.5f, 0.0f);
+
+  for (int i = 0; i < k_circle_segments; i++) {
+    int j = i + 1;
+    add_quad(
+        Vector2{center.x + m_cos[i] * outer, center.y + m_sin[i] * outer},
+        Vector2{center.x + m_cos[i] * inner, center.y + m_sin[i] * inner},
+        Vector2{center.x + m_cos[j] * inner, center.y + m_sin[j] * inner},
+        Vector2{center.x + m_cos[j] * outer, center.y + m_sin[j] * outer},
+        color);
+  }
+}
+
+void PrimitiveBatch::add_texture(const Texture2D& texture, Rectangle source,
+                                 Rectangle dest, Vector2 origin,
+                                 float rotation, Color tint) {
+  if (texture.id == 0) return;
+  use_texture(texture.id);
+
+  bool flip_x = false;
+  if (source.width < 0) {
+    flip_x = true;
+    source.width *= -1;
+  }
+  if (source.height < 0) source.y -= source.height;
+  if (dest.width < 0) dest.width *= -1;
+  if (dest.height < 0) dest.height *= -1;
+
+  // corners the way DrawTexturePro places them: top left, bottom left,
+  // bottom right, top right
+  float left = -origin.x;
+  float top = -origin.y;
+  float right = left + dest.width;
+  float bottom = top + dest.height;
+  float corner_x[4] = {left, left, right, right};
+  float corner_y[4] = {top, bottom, bottom, top};
+
+  float cos_r = 1.0f;
+  float sin_r = 0.0f;
+  if (rotation != 0.0f) {
+    cos_r = std::cos(rotation * DEG2RAD);
+    sin_r = std::sin(rotation * DEG2RAD);
+  }
+
+  float u0 = source.x / texture.width;
+  float u1 = (source.x + source.width) / texture.width;
+  float v0 = source.y / texture.height;
+  float v1 = (source.y + source.height) / texture.height;
+  if (flip_x) std::swap(u0, u1);
+  float corner_u[4] = {u0, u0, u1, u1};
+  float corner_v[4] = {v0, v1, v1, v0};
+
+  RenderVertex corners[4];
+  for (int i = 0; i < 4; i++) {
+    corners[i].x = dest.x + corner_x[i] * cos_r - corner_y[i] * sin_r;
+    corners[i].y = dest.y + corner_x[i] * sin_r + corner_y[i] * cos_r;
+    corners[i].u = corner_u[i];
+    corners[i].v = corner_v[i];
+    corners[i].color = tint;
+  }
+
+  for (int i : {0, 1, 2, 0, 2, 3}) {
+    m_vertices.push_back(corners[i]);
+  }
+}
+
+void PrimitiveBatch::flush() {
+  if (m_vertices.empty()) return;
+
+  RenderBackend::get().draw_triangles(m_texture, m_vertices.data(),
+                                      m_vertices.size());
+  m_vertices.clear();
+}
@@ -0,0 +1,147 @@
+#include "render/recording_backend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void RecordingBackend::clear() {
+  m_draws.clear();
+  m_frame_count = 0;
+  m_texture = k_no_texture;
+  m_texture_switch_count = 0;
+}
+
+size_t RecordingBackend::get_draw_count(RecordedDraw::Type type) const {
+  return std::count_if(
+      m_draws.begin(), m_draws.end(),
+      [type](const RecordedDraw& draw) { return draw.type == type; });
+}
+
+void RecordingBackend::record(RecordedDraw::Type type, Rectangle bounds,
+                              unsigned int texture, size_t vertex_count) {
+  // everything but lines and text is drawn from a texture, the default one
+  // for plain shapes
+  bool is_textured = type != RecordedDraw::Line && type != RecordedDraw::Text;
+  if (is_textured && texture != m_texture) {
+    m_texture = texture;
+    m_texture_switch_count++;
+  }
+  m_draws.push_back(
+      RecordedDraw{type, bounds, texture, m_target, vertex_count});
+}
+
+void RecordingBackend::begin_texture_mode(const RenderTexture2D& target) {
+  m_target = target.id;
+}
+
+void RecordingBackend::draw_line(Vector2 start, Vector2 end, Color) {
+  record(RecordedDraw::Line,
+         Rectangle{std::min(start.x, end.x), std::min(start.y, end.y),
+                   std::fabs(end.x - start.x), std::fabs(end.y - start.y)});
+}
+
+void RecordingBackend::draw_circle(Vector2 center, float radius, Color) {
+  record(RecordedDraw::Circle, Rectangle{center.x - radius, center.y - radius,
+                                         radius * 2, radius * 2});
+}
+
+void RecordingBackend::draw_circle_lines(Vector2 center, float radius,
+                                         Color) {
+  record(RecordedDraw::CircleLines,
+         Rectangle{center.x - radius, center.y - radius, radius * 2,
+                   radius * 2});
+}
+
+void RecordingBackend::draw_rectangle(Rectangle rect, Color) {
+  record(RecordedDraw::Rectangle, rect);
+}
+
+void RecordingBackend::draw_rectangle_lines(Rectangle rect, float, Color) {
+  record(RecordedDraw::RectangleLines, rect);
+}
+
+void RecordingBackend::draw_text(const char* text, Vector2 position,
+                                 int font_size, Color) {
+  // no font to measure with
+  float width = (float)std::strlen(text) * font_size;
+  record(RecordedDraw::Text,
+         Rectangle{position.x, position.y, width, (float)font_size});
+}
+
+void RecordingBackend::draw_texture(const Texture2D& texture, Rectangle,
+                                    Rectangle dest, Vector2 origin, float,
+                                    Color) {
+  record(RecordedDraw::Texture,
+         Rectangle{dest.x - origin.x, dest.y - origin.y, std::fabs(dest.width),
+                   std::fabs(dest.height)},
+         texture.id);
+}
+
+void RecordingBackend::draw_triangles(unsigned int texture,
+                                      const RenderVertex* vertices,
+                                      size_t count) {
+  if (count == 0) return;
+
+  float min_x = vertices[0].x, max_x = vertices[0].x;
+  float min_y = vertices[0].y, max_y = vertices[0].y;
+  for (size_t i = 1; i < count; i++) {
+    min_x = std::min(min_x, vertices[i].x);
+    max_x = std::max(max_x, vertices[i].x);
+    min_y = std::min(min_y, vertices[i].y);
+    max_y = std::max(max_y, vertices[i].y);
+  }
+
+  record(RecordedDraw::Triangles,
+         Rectangle{min_x, min_y, max_x - min_x, max_y - min_y}, texture,
+         count);
+}
+
+Texture2D RecordingBackend::make_texture(int width, int height) {
+  Texture2D texture = {};
+  texture.id = m_next_id++;
+  texture.width = width;
+  texture.height = height;
+  texture.mipmaps = 1;
+  texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+  m_texture_count++;
+  return texture;
+}
+
+// decodes the file only for its size, there is nothing to upload to
+Texture2D RecordingBackend::load_texture(const char* path) {
+  Image image = LoadImage(path);
+  if (image.data == nullptr) return Texture2D{};
+
+  Texture2D texture = make_texture(image.width, image.height);
+  UnloadImage(image);
+  return texture;
+}
+
+Texture2D RecordingBackend::load_texture_from_image(const Image& image) {
+  if (image.data == nullptr) return Texture2D{};
+  return make_texture(image.width, image.height);
+}
+
+void RecordingBackend::unload_texture(const Texture2D& texture) {
+  if (texture.id != 0 && m_texture_count > 0) m_texture_count--;
+}
+
+Font RecordingBackend::get_font_default() {
+  // glyphs are drawn from it, so it needs an id of its own
+  if (m_font.texture.id == 0) {
+    m_font.texture.id = m_next_id++;
+    m_font.texture.width = 1;
+    m_font.texture.height = 1;
+  }
+  return m_font;
+}
+
+RenderTexture2D RecordingBackend::load_render_texture(int width, int height) {
+  RenderTexture2D target = {};
+  target.texture = make_texture(width, height);
+  target.id = target.texture.id;
+  return target;
+}
+
+void RecordingBackend::unload_render_texture(const RenderTexture2D& target) {
+  unload_texture(target.texture);
+}
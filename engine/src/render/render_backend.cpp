@@ -0,0 +1,124 @@
+#include "render/render_backend.h"
+#include <algorithm>
+#include "rlgl.h"
+
+namespace {
+
+// vertices handed to rlgl between two batch limit checks, well below the
+// size of its default batch
+constexpr int k_chunk_vertices = 3 * 1024;
+
+class RaylibBackend : public RenderBackend {
+public:
+  void begin_drawing() override { BeginDrawing(); }
+  void end_drawing() override { EndDrawing(); }
+  void begin_mode2d(const Camera2D& camera) override { BeginMode2D(camera); }
+  void end_mode2d() override { EndMode2D(); }
+  void begin_texture_mode(const RenderTexture2D& target) override {
+    BeginTextureMode(target);
+  }
+  void end_texture_mode() override { EndTextureMode(); }
+  void begin_scissor_mode(int x, int y, int width, int height) override {
+    BeginScissorMode(x, y, width, height);
+  }
+  void end_scissor_mode() override { EndScissorMode(); }
+  void clear_background(Color color) override { ClearBackground(color); }
+
+  void draw_line(Vector2 start, Vector2 end, Color color) override {
+    DrawLineV(start, end, color);
+  }
+  void draw_circle(Vector2 center, float radius, Color color) override {
+    DrawCircleV(center, radius, color);
+  }
+  void draw_circle_lines(Vector2 center, float radius, Color color) override {
+    DrawCircleLines((int)center.x, (int)center.y, radius, color);
+  }
+  void draw_rectangle(Rectangle rect, Color color) override {
+    DrawRectangleRec(rect, color);
+  }
+  void draw_rectangle_lines(Rectangle rect, float thickness,
+                            Color color) override {
+    DrawRectangleLinesEx(rect, thickness, color);
+  }
+  void draw_text(const char* text, Vector2 position, int font_size,
+                 Color color) override {
+    DrawText(text, (int)position.x, (int)position.y, font_size, color);
+  }
+  void draw_texture(const Texture2D& texture, Rectangle source,
+                    Rectangle dest, Vector2 origin, float rotation,
+                    Color tint) override {
+    DrawTexturePro(texture, source, dest, origin, rotation, tint);
+  }
+  void draw_triangles(unsigned int texture, const RenderVertex* vertices,
+                      size_t count) override;
+
+  Texture2D load_texture(const char* path) override {
+    return LoadTexture(path);
+  }
+  Texture2D load_texture_from_image(const Image& image) override {
+    return LoadTextureFromImage(image);
+  }
+  void update_texture(const Texture2D& texture, const void* pixels) override {
+    UpdateTexture(texture, pixels);
+  }
+  // unloading needs the gl context, it may be gone at exit
+  void unload_texture(const Texture2D& texture) override {
+    if (IsWindowReady()) UnloadTexture(texture);
+  }
+  RenderTexture2D load_render_texture(int width, int height) override {
+    return LoadRenderTexture(width, height);
+  }
+  void unload_render_texture(const RenderTexture2D& target) override {
+    if (IsWindowReady()) UnloadRenderTexture(target);
+  }
+  Font get_font_default() override { return GetFontDefault(); }
+};
+
+void RaylibBackend::draw_triangles(unsigned int texture,
+                                   const RenderVertex* vertices,
+                                   size_t count) {
+  if (count == 0) return;
+
+  // shapes use the white default texture like raylib's own
+  rlSetTexture(texture != 0 ? texture : rlGetTextureIdDefault());
+
+  for (size_t start = 0; start < count; start += k_chunk_vertices) {
+    size_t end = std::min(start + k_chunk_vertices, count);
+
+    // rlgl draws what it has when the chunk wouldn't fit anymore
+    rlCheckRenderBatchLimit((int)(end - start));
+    rlBegin(RL_TRIANGLES);
+    for (size_t i = start; i < end; i++) {
+      const RenderVertex& vertex = vertices[i];
+      rlColor4ub(vertex.color.r, vertex.color.g, vertex.color.b,
+                 vertex.color.a);
+      rlTexCoord2f(vertex.u, vertex.v);
+      rlVertex2f(vertex.x, vertex.y);
+    }
+    rlEnd();
+  }
+
+  rlSetTexture(0);
+}
+
+// never destroyed, singletons unload their textures through it at exit
+RenderBackend* raylib_backend() {
+  static RenderBackend* backend = new RaylibBackend();
+  return backend;
+}
+
+RenderBackend* current_backend = nullptr;
+thread_local RenderBackend* thread_backend = nullptr;
+
+}  // namespace
+
+RenderBackend& RenderBackend::get() {
+  if (thread_backend) return *thread_backend;
+  return current_backend ? *current_backend : *raylib_backend();
+}
+
+void RenderBackend::set(RenderBackend* backend) { current_backend = backend; }
+
+void RenderBackend::set_for_thread(RenderBackend* backend) {
+  thread_backend = backend;
+}
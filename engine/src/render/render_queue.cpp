@@ -0,0 +1,620 @@
+#include "render/render_queue.h"
+#include <algorithm>
+#include <cmath>
+#include "config_manager/config_manager.h"
+#include "core/profiling.h"
+#include "core/raylib_wrapper.h"
+
+namespace {
+
+// layer and depth are stored biased so negative ones sort first
+inline uint64_t biased(int value) {
+  value = std::clamp(value, (int)INT16_MIN, (int)INT16_MAX);
+  return uint64_t(uint16_t(value ^ 0x8000));
+}
+
+constexpr int k_space_shift = 63;
+constexpr int k_layer_shift = 47;
+constexpr int k_depth_shift = 31;
+constexpr uint64_t k_material_mask = (uint64_t(1) << k_depth_shift) - 1;
+
+// bounds of a circle stored as center and radius
+inline Rectangle circle_bounds(const Rectangle& circle) {
+  return Rectangle{circle.x - circle.width, circle.y - circle.width,
+                   circle.width * 2, circle.width * 2};
+}
+
+// inclusive, so zero sized bounds on the edge of the view still count
+inline bool overlaps(const Rectangle& a, const Rectangle& b) {
+  return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+         a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// bounds of what the camera shows of a target, it may be rotated
+Rectangle world_view(const Camera2D& camera, float width, float height) {
+  Vector2 corners[4] = {GetScreenToWorld2D(Vector2{0, 0}, camera),
+                        GetScreenToWorld2D(Vector2{width, 0}, camera),
+                        GetScreenToWorld2D(Vector2{0, height}, camera),
+                        GetScreenToWorld2D(Vector2{width, height}, camera)};
+  float min_x = corners[0].x, max_x = corners[0].x;
+  float min_y = corners[0].y, max_y = corners[0].y;
+  for (const Vector2& corner : corners) {
+    min_x = std::min(min_x, corner.x);
+    max_x = std::max(max_x, corner.x);
+    min_y = std::min(min_y, corner.y);
+    max_y = std::max(max_y, corner.y);
+  }
+  return Rectangle{min_x, min_y, max_x - min_x, max_y - min_y};
+}
+
+inline Rectangle union_of(const Rectangle& a, const Rectangle& b) {
+  float min_x = std::min(a.x, b.x);
+  float min_y = std::min(a.y, b.y);
+  float max_x = std::max(a.x + a.width, b.x + b.width);
+  float max_y = std::max(a.y + a.height, b.y + b.height);
+  return Rectangle{min_x, min_y, max_x - min_x, max_y - min_y};
+}
+
+// fnv-1a
+inline void hash_bytes(uint64_t& hash, const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+// shapes don't name a texture, they go first within their layer and depth
+constexpr uint32_t k_no_material = 0;
+
+// for retire_texture, which must not construct the singleton
+RenderQueue* alive_queue = nullptr;
+
+}  // namespace
+
+uint64_t RenderQueue::make_key(int layer, int depth, uint32_t material) const {
+  return (uint64_t(m_space) << k_space_shift) |
+         (biased(layer) << k_layer_shift) | (biased(depth) << k_depth_shift) |
+         (material & k_material_mask);
+}
+
+RenderQueue::StaticScope::StaticScope(bool is_static)
+    : m_previous(RenderQueue::get().m_static) {
+  RenderQueue::get().m_static = is_static;
+}
+
+RenderQueue::StaticScope::~StaticScope() {
+  RenderQueue::get().m_static = m_previous;
+}
+
+RenderQueue::RenderQueue() {
+  // without static layers static commands are drawn like the others
+  m_use_static_layers = CONFIG_GET("render_static_layers", int, 1) != 0;
+  m_static_margin = std::max(CONFIG_GET("render_static_margin", int, 128), 0);
+  m_threaded = CONFIG_GET("render_threaded", int, 1) != 0;  // 0 draws inline
+  alive_queue = this;
+}
+
+RenderQueue::~RenderQueue() {
+  alive_queue = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_worker_running = false;
+  }
+  m_job_cv.notify_all();
+
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+
+  for (StaticLayer& layer : m_static_layers) {
+    if (layer.target.id != 0) unload_render_texture(layer.target);
+  }
+  unload_retired(m_retiring_textures);
+  unload_retired(m_retired_textures);
+}
+
+RenderQueue::Command& RenderQueue::push(Kind kind, Rectangle bounds,
+                                        Color color, int layer, int depth,
+                                        uint32_t material) {
+  Command& command = m_commands.emplace_back();
+  command.key = make_key(layer, depth, material);
+  command.kind = kind;
+  command.color = color;
+  command.bounds = bounds;
+  command.is_static = m_static;
+  return command;
+}
+
+void RenderQueue::draw_rectangle(Rectangle rect, Color color, int layer,
+                                 int depth) {
+  push(Kind::Rectangle, rect, color, layer, depth, k_no_material).rect = rect;
+}
+
+void RenderQueue::draw_rectangle_lines(Rectangle rect, float thickness,
+                                       Color color, int layer, int depth) {
+  // DrawRectangleLinesEx draws inside the rectangle
+  Command& command =
+      push(Kind::RectangleLines, rect, color, layer, depth, k_no_material);
+  command.rect = rect;
+  command.thickness = thickness;
+}
+
+void RenderQueue::draw_circle(Vector2 center, float radius, Color color,
+                              int layer, int depth) {
+  Rectangle circle = {center.x, center.y, radius, radius};
+  push(Kind::Circle, circle_bounds(circle), color, layer, depth, k_no_material)
+      .rect = circle;
+}
+
+void RenderQueue::draw_circle_lines(Vector2 center, float radius, Color color,
+                                    int layer, int depth) {
+  Rectangle circle = {center.x, center.y, radius, radius};
+  push(Kind::CircleLines, circle_bounds(circle), color, layer, depth,
+       k_no_material)
+      .rect = circle;
+}
+
+void RenderQueue::draw_texture(const SpriteFrame& frame, Rectangle dest,
+                               Vector2 origin, float rotation, Color tint,
+                               int layer, int depth) {
+  if (frame.texture.id == 0) return;
+
+  Rectangle bounds = {dest.x - origin.x, dest.y - origin.y,
+                      std::fabs(dest.width), std::fabs(dest.height)};
+  if (rotation != 0.0f) {
+    // whatever the angle, the quad stays within its farthest corner from
+    // the pivot
+    float x = std::max(std::fabs(origin.x), std::fabs(bounds.width - origin.x));
+    float y =
+        std::max(std::fabs(origin.y), std::fabs(bounds.height - origin.y));
+    bounds = circle_bounds(
+        Rectangle{dest.x, dest.y, std::sqrt(x * x + y * y), 0.0f});
+  }
+
+  Command& command =
+      push(Kind::Texture, bounds, tint, layer, depth, frame.texture.id);
+  command.rect = dest;
+  command.texture = frame.texture;
+  command.source = frame.source;
+  command.origin = origin;
+  command.rotation = rotation;
+}
+
+void RenderQueue::draw_text(const char* text, Vector2 position,
+                            float font_size, Color color, int layer,
+                            int depth) {
+  if (text == nullptr || text[0] == '\0') return;
+
+  const TextRun& run = m_text_cache.get(text, font_size);
+  Rectangle bounds = {position.x, position.y, run.width, run.height};
+
+  Command& command =
+      push(Kind::Text, bounds, color, layer, depth, run.texture.id);
+  command.rect = bounds;
+  command.run = &run;
+}
+
+void RenderQueue::submit(const RenderTexture2D& target,
+                         const Camera2D& camera, Color background) {
+  ZPROFILE_ZONE_NAMED("RenderQueue::submit()");
+
+  // atlas pages that got new images since the last frame
+  SpriteBatch::get().upload();
+
+  wait_for_job();
+  m_stats = m_job_stats;
+
+  prepare_static_layers(target.texture.width, target.texture.height);
+
+  m_packet.commands.swap(m_commands);
+  m_commands.clear();
+  m_packet.target = target;
+  m_packet.camera = camera;
+  m_packet.background = background;
+
+  // the runs of the packet were used this frame, they outlive it
+  m_text_cache.end_frame();
+
+  if (!m_threaded) {
+    draw_packet();
+    m_stats = m_job_stats;
+  } else {
+    // recorded while this frame was simulated
+    const DeferredBackend& recorded = m_frames[m_recording];
+    m_recording ^= 1;
+    start_job(m_recording);
+
+    if (m_has_recorded) {
+      recorded.replay(RenderBackend::get());
+    } else {
+      begin_texture_mode(target);
+      clear_background(background);
+      end_texture_mode();
+    }
+    m_has_recorded = true;
+  }
+
+  for (const RenderTexture2D& layer : m_retired_layers) {
+    unload_render_texture(layer);
+  }
+  m_retired_layers.clear();
+
+  // threaded, the ones of this frame wait for the replay of its packet
+  unload_retired(m_retiring_textures);
+  m_retiring_textures.swap(m_retired_textures);
+  if (!m_threaded) unload_retired(m_retiring_textures);
+}
+
+void RenderQueue::set_threaded(bool threaded) {
+  if (threaded == m_threaded) return;
+
+  wait_for_job();
+  if (m_has_recorded) {
+    m_frames[m_recording].replay(RenderBackend::get());
+    unload_retired(m_retiring_textures);
+  }
+  m_has_recorded = false;
+  m_threaded = threaded;
+}
+
+void RenderQueue::unload_retired(std::vector<Texture2D>& textures) {
+  for (const Texture2D& texture : textures) {
+    unload_texture(texture);
+  }
+  textures.clear();
+}
+
+void RenderQueue::retire_texture(const Texture2D& texture) {
+  if (texture.id == 0) return;
+
+  if (alive_queue) {
+    alive_queue->m_retired_textures.push_back(texture);
+  } else {
+    unload_texture(texture);
+  }
+}
+
+void RenderQueue::prepare_static_layers(int width, int height) {
+  if (!m_use_static_layers) return;
+
+  // the screen layer never moves, it needs no margin
+  int margins[2] = {m_static_margin, 0};
+  for (int space = 0; space < 2; space++) {
+    StaticLayer& layer = m_static_layers[space];
+    int layer_width = width + 2 * margins[space];
+    int layer_height = height + 2 * margins[space];
+    if (layer.target.id != 0 && layer.target.texture.width == layer_width &&
+        layer.target.texture.height == layer_height) {
+      continue;
+    }
+
+    if (layer.target.id != 0) m_retired_layers.push_back(layer.target);
+    layer.target = load_render_texture(layer_width, layer_height);
+    layer.is_valid = false;
+  }
+}
+
+void RenderQueue::start_job(int frame) {
+  if (!m_worker.joinable()) {
+    m_worker = std::thread(&RenderQueue::worker_loop, this);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_job_frame = frame;
+    m_job_pending = true;
+  }
+  m_job_cv.notify_all();
+}
+
+void RenderQueue::wait_for_job() {
+  ZPROFILE_ZONE_NAMED("RenderQueue::wait_for_job()");
+
+  std::unique_lock<std::mutex> lock(m_job_mutex);
+  m_job_cv.wait(lock, [this] { return !m_job_pending; });
+}
+
+void RenderQueue::worker_loop() {
+  while (true) {
+    int frame;
+    {
+      std::unique_lock<std::mutex> lock(m_job_mutex);
+      m_job_cv.wait(lock,
+                    [this] { return !m_worker_running || m_job_pending; });
+      if (!m_worker_running) return;
+      frame = m_job_frame;
+    }
+
+    DeferredBackend& recording = m_frames[frame];
+    recording.clear();
+    RenderBackend::set_for_thread(&recording);
+    draw_packet();
+    RenderBackend::set_for_thread(nullptr);
+
+    {
+      std::lock_guard<std::mutex> lock(m_job_mutex);
+      m_job_pending = false;
+    }
+    m_job_cv.notify_all();
+  }
+}
+
+void RenderQueue::draw_packet() {
+  ZPROFILE_ZONE_NAMED("RenderQueue::draw_packet()");
+
+  const std::vector<Command>& commands = m_packet.commands;
+  const RenderTexture2D& target = m_packet.target;
+  int width = target.texture.width;
+  int height = target.texture.height;
+
+  // screen commands go through an identity camera
+  Camera2D cameras[2] = {m_packet.camera, Camera2D{}};
+  cameras[(int)Space::Screen].zoom = 1.0f;
+
+  Rectangle views[2];
+  views[(int)Space::World] = world_view(m_packet.camera, width, height);
+  views[(int)Space::Screen] = Rectangle{0, 0, (float)width, (float)height};
+
+  // static commands are culled against their layer instead
+  for (int space = 0; space < 2; space++) {
+    m_order[space].clear();
+    m_static_order[space].clear();
+  }
+  for (uint32_t i = 0; i < commands.size(); i++) {
+    const Command& command = commands[i];
+    int space = (int)(command.key >> k_space_shift);
+    if (command.is_static && m_use_static_layers) {
+      m_static_order[space].push_back(i);
+    } else if (overlaps(command.bounds, views[space])) {
+      m_order[space].push_back(i);
+    }
+  }
+
+  // stable, so commands with the same key keep their submission order
+  auto by_key = [&commands](uint32_t lhs, uint32_t rhs) {
+    return commands[lhs].key < commands[rhs].key;
+  };
+  Stats& stats = m_job_stats;
+  stats = Stats{};
+  for (int space = 0; space < 2; space++) {
+    std::stable_sort(m_order[space].begin(), m_order[space].end(), by_key);
+    std::stable_sort(m_static_order[space].begin(),
+                     m_static_order[space].end(), by_key);
+    stats.command_count += m_order[space].size();
+    stats.static_count += m_static_order[space].size();
+  }
+  stats.culled_count =
+      commands.size() - stats.command_count - stats.static_count;
+
+  // before the target is bound, they have render textures of their own
+  if (m_use_static_layers) {
+    update_static_layer(m_static_layers[(int)Space::World],
+                        m_static_order[(int)Space::World],
+                        cameras[(int)Space::World], m_static_margin);
+    update_static_layer(m_static_layers[(int)Space::Screen],
+                        m_static_order[(int)Space::Screen],
+                        cameras[(int)Space::Screen], 0);
+  }
+
+  begin_texture_mode(target);
+  clear_background(m_packet.background);
+
+  for (int space = 0; space < 2; space++) {
+    if (m_use_static_layers) composite(m_static_layers[space], cameras[space]);
+
+    begin_mode2d(cameras[space]);
+    stats.state_changes++;
+
+    uint64_t material = k_no_material;
+    for (uint32_t index : m_order[space]) {
+      const Command& command = commands[index];
+
+      uint64_t command_material = command.key & k_material_mask;
+      if (command_material != material) {
+        material = command_material;
+        stats.state_changes++;
+      }
+
+      execute(command);
+    }
+
+    m_primitives.flush();
+    end_mode2d();
+  }
+
+  end_texture_mode();
+}
+
+uint64_t RenderQueue::hash(const Command& command) {
+  uint64_t hash = 14695981039346656037ull;
+  hash_bytes(hash, &command.key, sizeof(command.key));
+  hash_bytes(hash, &command.kind, sizeof(command.kind));
+  hash_bytes(hash, &command.color, sizeof(command.color));
+  hash_bytes(hash, &command.rect, sizeof(command.rect));
+  hash_bytes(hash, &command.thickness, sizeof(command.thickness));
+  hash_bytes(hash, &command.texture.id, sizeof(command.texture.id));
+  hash_bytes(hash, &command.source, sizeof(command.source));
+  hash_bytes(hash, &command.origin, sizeof(command.origin));
+  hash_bytes(hash, &command.rotation, sizeof(command.rotation));
+  hash_bytes(hash, &command.run, sizeof(command.run));
+  return hash;
+}
+
+void RenderQueue::update_static_layer(StaticLayer& layer,
+                                      const std::vector<uint32_t>& order,
+                                      const Camera2D& camera, int margin) {
+  // sized by prepare_static_layers
+  int layer_width = layer.target.texture.width;
+  int layer_height = layer.target.texture.height;
+  int width = layer_width - 2 * margin;
+  int height = layer_height - 2 * margin;
+
+  // the layer still has to cover the whole view
+  if (layer.is_valid) {
+    bool same_transform = layer.camera.zoom == camera.zoom &&
+                          layer.camera.rotation == camera.rotation;
+    Vector2 corner = get_world_to_screen2d(
+        get_screen_to_world2d(Vector2{0, 0}, layer.camera), camera);
+    layer.is_valid = same_transform && corner.x <= 0 && corner.y <= 0 &&
+                     corner.x + layer_width >= width &&
+                     corner.y + layer_height >= height;
+  }
+  if (!layer.is_valid) {
+    layer.camera = camera;
+    layer.camera.offset.x += margin;
+    layer.camera.offset.y += margin;
+  }
+
+  Rectangle coverage = world_view(layer.camera, layer_width, layer_height);
+  m_static_entries.clear();
+  for (uint32_t index : order) {
+    const Command& command = m_packet.commands[index];
+    if (overlaps(command.bounds, coverage)) {
+      m_static_entries.push_back(StaticEntry{hash(command), command.bounds});
+    }
+  }
+  std::sort(m_static_entries.begin(), m_static_entries.end(),
+            [](const StaticEntry& lhs, const StaticEntry& rhs) {
+              return lhs.hash < rhs.hash;
+            });
+
+  if (!layer.is_valid) {
+    redraw_static_layer(layer, order, nullptr);
+    layer.is_valid = true;
+    layer.entries.swap(m_static_entries);
+    return;
+  }
+
+  // the commands that came or went, their bounds are what changed
+  bool is_dirty = false;
+  Rectangle dirty = {};
+  auto add_dirty = [&](const Rectangle& bounds) {
+    dirty = is_dirty ? union_of(dirty, bounds) : bounds;
+    is_dirty = true;
+  };
+  size_t i = 0, j = 0;
+  const std::vector<StaticEntry>& previous = layer.entries;
+  const std::vector<StaticEntry>& current = m_static_entries;
+  while (i < previous.size() || j < current.size()) {
+    if (j == current.size() ||
+        (i < previous.size() && previous[i].hash < current[j].hash)) {
+      add_dirty(previous[i++].bounds);
+    } else if (i == previous.size() || current[j].hash < previous[i].hash) {
+      add_dirty(current[j++].bounds);
+    } else {
+      i++;
+      j++;
+    }
+  }
+
+  if (is_dirty) {
+    // regions are axis aligned in the layer only without rotation
+    redraw_static_layer(layer, order,
+                        layer.camera.rotation == 0.0f ? &dirty : nullptr);
+  }
+  layer.entries.swap(m_static_entries);
+}
+
+void RenderQueue::redraw_static_layer(StaticLayer& layer,
+                                      const std::vector<uint32_t>& order,
+                                      const Rectangle* region) {
+  m_job_stats.static_redraw_count++;
+
+  int layer_width = layer.target.texture.width;
+  int layer_height = layer.target.texture.height;
+  Rectangle area = world_view(layer.camera, layer_width, layer_height);
+
+  begin_texture_mode(layer.target);
+
+  // whole pixels around the region, with one to spare for edges that
+  // round outwards
+  if (region) {
+    Vector2 min = get_world_to_screen2d(Vector2{region->x, region->y},
+                                        layer.camera);
+    Vector2 max = get_world_to_screen2d(
+        Vector2{region->x + region->width, region->y + region->height},
+        layer.camera);
+    int left = std::max((int)std::floor(min.x) - 1, 0);
+    int top = std::max((int)std::floor(min.y) - 1, 0);
+    int right = std::min((int)std::ceil(max.x) + 1, layer_width);
+    int bottom = std::min((int)std::ceil(max.y) + 1, layer_height);
+    if (right <= left || bottom <= top) {
+      end_texture_mode();
+      return;
+    }
+
+    begin_scissor_mode(left, top, right - left, bottom - top);
+    Vector2 area_min = get_screen_to_world2d(
+        Vector2{(float)left, (float)top}, layer.camera);
+    Vector2 area_max = get_screen_to_world2d(
+        Vector2{(float)right, (float)bottom}, layer.camera);
+    area = Rectangle{area_min.x, area_min.y, area_max.x - area_min.x,
+                     area_max.y - area_min.y};
+  }
+
+  clear_background(BLANK);
+  begin_mode2d(layer.camera);
+  for (uint32_t index : order) {
+    const Command& command = m_packet.commands[index];
+    if (overlaps(command.bounds, area)) execute(command);
+  }
+  m_primitives.flush();
+  end_mode2d();
+
+  if (region) end_scissor_mode();
+  end_texture_mode();
+}
+
+void RenderQueue::composite(const StaticLayer& layer, const Camera2D& camera) {
+  if (!layer.is_valid || layer.entries.empty()) return;
+
+  // where the top left of the layer is now
+  Vector2 corner = get_world_to_screen2d(
+      get_screen_to_world2d(Vector2{0, 0}, layer.camera), camera);
+  const Texture2D& texture = layer.target.texture;
+
+  // render textures are upside down
+  m_primitives.add_texture(
+      texture, Rectangle{0, 0, (float)texture.width, (float)-texture.height},
+      Rectangle{corner.x, corner.y, (float)texture.width,
+                (float)texture.height},
+      Vector2{0, 0}, 0.0f, WHITE);
+  m_primitives.flush();
+  m_job_stats.state_changes++;
+}
+
+void RenderQueue::execute(const Command& command) {
+  const Rectangle& rect = command.rect;
+
+  switch (command.kind) {
+    case Kind::Rectangle:
+      m_primitives.add_rectangle(rect, command.color);
+      break;
+    case Kind::RectangleLines:
+      m_primitives.add_rectangle_lines(rect, command.thickness, command.color);
+      break;
+    case Kind::Circle:
+      m_primitives.add_circle(Vector2{rect.x, rect.y}, rect.width,
+                              command.color);
+      break;
+    case Kind::CircleLines:
+      m_primitives.add_circle_lines(Vector2{rect.x, rect.y}, rect.width,
+                                    command.color);
+      break;
+    case Kind::Texture:
+      m_primitives.add_texture(command.texture, command.source, rect,
+                               command.origin, command.rotation,
+                               command.color);
+      break;
+    case Kind::Text:
+      for (const TextGlyph& glyph : command.run->glyphs) {
+        Rectangle dest = {rect.x + glyph.dest.x, rect.y + glyph.dest.y,
+                          glyph.dest.width, glyph.dest.height};
+        m_primitives.add_texture(command.run->texture, glyph.source, dest,
+                                 Vector2{0, 0}, 0.0f, command.color);
+      }
+      break;
+  }
+}
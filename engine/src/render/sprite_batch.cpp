@@ -0,0 +1,59 @@
+#include "render/sprite_batch.h"
+#include "remote_logger/remote_logger.h"
+
+bool SpriteBatch::load(const std::string& path, SpriteFrame& frame) {
+  auto it = m_atlas_frames.find(path);
+  if (it != m_atlas_frames.end()) {
+    frame = it->second;
+    return true;
+  }
+
+  // big images are only decoded once too
+  TextureHandle cached = ResourceManager::get().find_texture(path);
+  if (cached) {
+    frame.texture = cached.get();
+    frame.source = Rectangle{0, 0, (float)frame.texture.width,
+                             (float)frame.texture.height};
+    frame.handle = std::move(cached);
+    return true;
+  }
+
+  Image image = LoadImage(path.c_str());
+  if (image.data == nullptr) {
+    log_error() << "Failed to load sprite image: " << path << std::endl;
+    return false;
+  }
+
+  if (image.width > k_max_atlas_image || image.height > k_max_atlas_image) {
+    frame.handle = ResourceManager::get().load_texture(path, image);
+    UnloadImage(image);
+    if (!frame.handle) return false;
+
+    frame.texture = frame.handle.get();
+    frame.source = Rectangle{0, 0, (float)frame.texture.width,
+                             (float)frame.texture.height};
+    return true;
+  }
+
+  // first page with room, a new one when they're all full
+  Rectangle region;
+  bool placed = !m_pages.empty() && m_pages.back()->add(image, region);
+  if (!placed) {
+    m_pages.push_back(std::make_unique<TextureAtlas>());
+    placed = m_pages.back()->add(image, region);
+  }
+  UnloadImage(image);
+  if (!placed) return false;
+
+  frame.texture = m_pages.back()->get_texture();
+  frame.source = region;
+  frame.handle.reset();
+  m_atlas_frames[path] = frame;
+  return true;
+}
+
+void SpriteBatch::upload() {
+  for (auto& page : m_pages) {
+    page->upload();
+  }
+}
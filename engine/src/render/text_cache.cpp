@@ -0,0 +1,107 @@
+#include "render/text_cache.h"
+#include <algorithm>
+#include <cstring>
+#include "core/raylib_wrapper.h"
+
+namespace {
+
+constexpr int k_default_font_size = 10;
+// raylib 5.5 advances lines by the font size and this, SetTextLineSpacing
+// changes it and the engine never calls it
+constexpr int k_line_spacing = 2;
+
+}  // namespace
+
+const TextRun& TextCache::get(const char* text, float font_size) {
+  // DrawText takes whole sizes and draws nothing smaller than the font
+  int size = std::max((int)font_size, k_default_font_size);
+
+  m_key.assign(text);
+  m_key.push_back('\0');
+  m_key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+
+  auto [it, inserted] = m_runs.try_emplace(m_key);
+  TextRun& run = it->second;
+  if (inserted) {
+    layout(text, size, run);
+    m_layouts++;
+  }
+  run.last_used = m_frame;
+  return run;
+}
+
+void TextCache::end_frame() {
+  m_layout_count = m_layouts;
+  m_layouts = 0;
+
+  m_frame++;
+  if (m_frame % k_prune_interval != 0) return;
+
+  for (auto it = m_runs.begin(); it != m_runs.end();) {
+    if (m_frame - it->second.last_used > k_max_idle_frames) {
+      it = m_runs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// what DrawText and DrawTextEx do per glyph
+void TextCache::layout(const char* text, int font_size, TextRun& run) {
+  Font font = get_font_default();
+  run.texture = font.texture;
+
+  float scale = (float)font_size / font.baseSize;
+  float spacing = (float)(font_size / k_default_font_size);
+  float padding = (float)font.glyphPadding;
+  float line_height = (float)(font_size + k_line_spacing);
+
+  float x = 0.0f;
+  float y = 0.0f;
+  size_t length = std::strlen(text);
+  for (size_t i = 0; i < length;) {
+    int codepoint_size = 0;
+    int codepoint = GetCodepoint(&text[i], &codepoint_size);
+    i += std::max(codepoint_size, 1);
+
+    if (codepoint == '\n') {
+      run.width = std::max(run.width, x);
+      x = 0.0f;
+      y += line_height;
+      continue;
+    }
+
+    // no font without a window, a box per glyph keeps sizes and glyph counts
+    // close for headless runs
+    if (font.glyphs == nullptr) {
+      if (codepoint != ' ' && codepoint != '\t') {
+        run.glyphs.push_back(TextGlyph{
+            Rectangle{x, y, font_size / 2.0f, (float)font_size}, Rectangle{}});
+      }
+      x += font_size / 2.0f + spacing;
+      continue;
+    }
+
+    int index = GetGlyphIndex(font, codepoint);
+    const GlyphInfo& glyph = font.glyphs[index];
+    const Rectangle& rec = font.recs[index];
+
+    if (codepoint != ' ' && codepoint != '\t') {
+      TextGlyph quad;
+      quad.dest = Rectangle{x + (glyph.offsetX - padding) * scale,
+                            y + (glyph.offsetY - padding) * scale,
+                            (rec.width + 2 * padding) * scale,
+                            (rec.height + 2 * padding) * scale};
+      quad.source = Rectangle{rec.x - padding, rec.y - padding,
+                              rec.width + 2 * padding,
+                              rec.height + 2 * padding};
+      run.glyphs.push_back(quad);
+    }
+
+    float advance = glyph.advanceX == 0 ? rec.width : glyph.advanceX;
+    x += advance * scale + spacing;
+  }
+
+  run.width = std::max(run.width, x);
+  run.height = y + font_size;
+}
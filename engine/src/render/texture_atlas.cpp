@@ -0,0 +1,45 @@
+#include "render/texture_atlas.h"
+#include <algorithm>
+#include "core/raylib_wrapper.h"
+
+TextureAtlas::TextureAtlas(int size) : m_size(size) {
+  m_image = GenImageColor(size, size, BLANK);
+  m_texture = load_texture_from_image(m_image);
+}
+
+TextureAtlas::~TextureAtlas() {
+  unload_texture(m_texture);
+  UnloadImage(m_image);
+}
+
+bool TextureAtlas::add(const Image& image, Rectangle& region) {
+  int width = image.width + k_padding;
+  int height = image.height + k_padding;
+  if (width > m_size || height > m_size) return false;
+
+  // next shelf once this one is full
+  if (m_shelf_x + width > m_size) {
+    m_shelf_y += m_shelf_height;
+    m_shelf_x = 0;
+    m_shelf_height = 0;
+  }
+  if (m_shelf_y + height > m_size) return false;
+
+  region = Rectangle{(float)m_shelf_x, (float)m_shelf_y, (float)image.width,
+                     (float)image.height};
+  ImageDraw(&m_image, image,
+            Rectangle{0, 0, (float)image.width, (float)image.height}, region,
+            WHITE);
+
+  m_shelf_x += width;
+  m_shelf_height = std::max(m_shelf_height, height);
+  m_dirty = true;
+  return true;
+}
+
+void TextureAtlas::upload() {
+  if (!m_dirty) return;
+
+  update_texture(m_texture, m_image.data);
+  m_dirty = false;
+}
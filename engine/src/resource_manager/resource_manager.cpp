@@ -1,5 +1,15 @@
 #include "resource_manager/resource_manager.h"
+#include "core/profiling.h"
+#include "core/raylib_wrapper.h"
 #include "remote_logger/remote_logger.h"
+#include "render/render_queue.h"
+
+struct CachedTexture {
+  std::string path;
+  Texture2D texture;
+  size_t bytes = 0;
+  int ref_count = 0;
+};
 
 namespace {
 const char* ENGINE = "engine";
@@ -9,6 +19,14 @@ const char* SHARED_RESOUCES = "shared_resources";
 
 ResourceManager::ResourceManager() { construct_paths(); }
 
+ResourceManager::~ResourceManager() {
+  // everything holding a handle is expected to be gone by now
+  if (!m_textures.empty()) {
+    log_warning() << "[ResourceManager] " << m_textures.size()
+                  << " textures still referenced at exit" << std::endl;
+  }
+}
+
 void ResourceManager::construct_paths() {
   std::filesystem::path current_dir = get_search_start_dir();
 
@@ -77,3 +95,110 @@ std::filesystem::path ResourceManager::get_variant_path(
     const std::string& name) const {
   return get_variants_path() / (name + ".variant");
 }
+
+TextureHandle ResourceManager::load_texture(const std::string& path) {
+  TextureHandle cached = find_texture(path);
+  if (cached) return cached;
+
+  ZPROFILE_ZONE_NAMED("ResourceManager::load_texture()");
+
+  Texture2D texture = ::load_texture(path.c_str());
+  if (texture.id == 0) {
+    log_error() << "Failed to load texture: " << path << std::endl;
+    return TextureHandle();
+  }
+  return add_texture(path, texture);
+}
+
+TextureHandle ResourceManager::load_texture(const std::string& path,
+                                            const Image& image) {
+  TextureHandle cached = find_texture(path);
+  if (cached) return cached;
+
+  Texture2D texture = load_texture_from_image(image);
+  if (texture.id == 0) {
+    log_error() << "Failed to upload texture: " << path << std::endl;
+    return TextureHandle();
+  }
+  return add_texture(path, texture);
+}
+
+TextureHandle ResourceManager::find_texture(const std::string& path) {
+  auto it = m_textures.find(path);
+  if (it == m_textures.end()) return TextureHandle();
+
+  m_texture_stats.hits++;
+  return TextureHandle(it->second.get());
+}
+
+TextureHandle ResourceManager::add_texture(const std::string& path,
+                                           Texture2D texture) {
+  auto cached = std::make_unique<CachedTexture>();
+  cached->path = path;
+  cached->texture = texture;
+  cached->bytes = (size_t)GetPixelDataSize(texture.width, texture.height,
+                                           texture.format);
+
+  m_texture_stats.loads++;
+  m_texture_stats.texture_count++;
+  m_texture_stats.bytes += cached->bytes;
+
+  CachedTexture* raw = cached.get();
+  m_textures[path] = std::move(cached);
+  return TextureHandle(raw);
+}
+
+void ResourceManager::release_texture(CachedTexture* texture) {
+  if (--texture->ref_count > 0) return;
+
+  // frames queued or recorded before the release may still draw it
+  RenderQueue::retire_texture(texture->texture);
+
+  m_texture_stats.unloads++;
+  m_texture_stats.texture_count--;
+  m_texture_stats.bytes -= texture->bytes;
+  m_textures.erase(texture->path);
+}
+
+TextureHandle::TextureHandle(CachedTexture* texture) : m_texture(texture) {
+  m_texture->ref_count++;
+}
+
+TextureHandle::TextureHandle(const TextureHandle& other)
+    : m_texture(other.m_texture) {
+  if (m_texture) m_texture->ref_count++;
+}
+
+TextureHandle::TextureHandle(TextureHandle&& other) noexcept
+    : m_texture(other.m_texture) {
+  other.m_texture = nullptr;
+}
+
+TextureHandle& TextureHandle::operator=(const TextureHandle& other) {
+  CachedTexture* texture = other.m_texture;
+  if (texture) texture->ref_count++;
+  reset();
+  m_texture = texture;
+  return *this;
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle&& other) noexcept {
+  if (this != &other) {
+    reset();
+    m_texture = other.m_texture;
+    other.m_texture = nullptr;
+  }
+  return *this;
+}
+
+TextureHandle::~TextureHandle() { reset(); }
+
+const Texture2D& TextureHandle::get() const { return m_texture->texture; }
+
+void TextureHandle::reset() {
+  if (!m_texture) return;
+
+  CachedTexture* texture = m_texture;
+  m_texture = nullptr;
+  ResourceManager::get().release_texture(texture);
+}